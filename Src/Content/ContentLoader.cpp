@@ -4,9 +4,37 @@
 #include "../Graphics/TextureLoader.h"
 #include "../Graphics/Model.h"
 #include "../Audio/AudioLoader.h"
+#include "../FileFinder.h"
+#include "../Utils.h"
 
 namespace Content
 {
+	bool ContentLoaderParams::OpenAndMap(const char* filename, FoundFile* result)
+	{
+		Utils::Stopwatch timer;
+		timer.Start();
+
+		bool opened = FileFinder::OpenAndMap(filename, result);
+		if (opened)
+			BytesRead += result->FileSize;
+
+		ReadMicroseconds += (uint32)timer.GetElapsedMicroseconds();
+		return opened;
+	}
+
+	bool ContentLoaderParams::OpenAndMap(StringRef filename, FoundFile* result)
+	{
+		Utils::Stopwatch timer;
+		timer.Start();
+
+		bool opened = FileFinder::OpenAndMap(filename, result);
+		if (opened)
+			BytesRead += result->FileSize;
+
+		ReadMicroseconds += (uint32)timer.GetElapsedMicroseconds();
+		return opened;
+	}
+
 	struct ContentLoaderData
 	{
 		std::vector<Loader> Loaders;
@@ -23,10 +51,10 @@ namespace Content
 
 		// function pointers within the lib have to be reset
 		m_data->Loaders.clear();
-		m_data->Loaders.push_back(Loader{ ResourceType::Model, (JobFunc)Graphics::Model::LoadObj, nullptr, device, sizeof(Graphics::Model), alignof(Graphics::Model) });
-		m_data->Loaders.push_back(Loader{ ResourceType::Texture2D, (JobFunc)Graphics::TextureLoader::LoadPixels, nullptr });
-		m_data->Loaders.push_back(Loader{ ResourceType::Bitmap, (JobFunc)Graphics::TextureLoader::LoadPixels, nullptr });
-		m_data->Loaders.push_back(Loader{ ResourceType::Audio, (JobFunc)Audio::AudioLoader::LoadWav, nullptr });
+		m_data->Loaders.push_back(Loader{ ResourceType::Model, (JobFunc)Graphics::Model::LoadObj, (JobFunc)Graphics::Model::Unload, device, sizeof(Graphics::Model), alignof(Graphics::Model) });
+		m_data->Loaders.push_back(Loader{ ResourceType::Texture2D, (JobFunc)Graphics::TextureLoader::LoadPixels, (JobFunc)Graphics::TextureLoader::Unload });
+		m_data->Loaders.push_back(Loader{ ResourceType::Bitmap, (JobFunc)Graphics::TextureLoader::LoadPixels, (JobFunc)Graphics::TextureLoader::Unload });
+		m_data->Loaders.push_back(Loader{ ResourceType::Audio, (JobFunc)Audio::AudioLoader::LoadWav, (JobFunc)Audio::AudioLoader::UnloadWav });
 		m_data->Loaders.push_back(Loader{ ResourceType::Cursor, (JobFunc)Gui::GuiManager::LoadCursor, nullptr });
 	}
 
@@ -59,7 +87,7 @@ namespace Content
 			extLen = (int)(extEnd - ext);
 
 		const uint32 maxExtLength = 6;
-		char extBuffer[maxExtLength + 1];
+		char extBuffer[maxExtLength + 1] = {};
 #ifdef _MSC_VER
 		strncpy_s(extBuffer, ext, maxExtLength < extLen ? maxExtLength : extLen);
 #else
@@ -6,6 +6,8 @@
 #include "../JobQueue.h"
 #include "../StringManager.h"
 
+struct FoundFile;
+
 namespace Content
 {
 	enum class ContentState
@@ -54,7 +56,7 @@ namespace Content
 	{
 		ResourceType Type;
 		JobFunc LoaderFunc;
-		JobFunc UnloaderFunc;
+		JobFunc UnloaderFunc; // gets a ContentLoaderParams with Destination pointing at the content. Content without one never gets unloaded.
 		void* LoaderParam;
 
 		uint32 ResourceSize;
@@ -68,21 +70,57 @@ namespace Content
 		Fixup
 	};
 
+	// the top 16 bits are the file slot's generation, the bottom 16 are the slot's index (just like JobHandle)
+	typedef uint32 ContentHandle;
+
+	struct ContentDependency
+	{
+		StringRef Filename;
+		ResourceType Type;
+		ContentHandle Handle; // filled in once it's been requested
+	};
+
 	struct ContentLoaderParams
 	{
 		static const uint32 LocalDataStorageSize = 32;
 		uint8* LocalDataStorage;
 
+		// Files the content needs, which the AsyncLoad or MainThread phase can add to. They all get requested at once
+		// after the MainThread phase, and the Fixup phase doesn't run until they've all loaded (or failed to).
+		static const uint32 MaxDependencies = 16;
+		ContentDependency Dependencies[MaxDependencies];
+		uint32 NumDependencies;
+
+		bool AddDependency(StringRef filename, ResourceType type)
+		{
+			if (NumDependencies == MaxDependencies)
+				return false;
+
+			Dependencies[NumDependencies].Filename = filename;
+			Dependencies[NumDependencies].Type = type;
+			NumDependencies++;
+			return true;
+		}
+
 		// input
 		LoaderPhase Phase;
 		ResourceType Type;
 		StringRef FilenameHash;
 		void* LoaderParam;
 		JobHandle Job;
+		void* Replacing; // when the file's being reloaded, the old version (which is still in use until the new one's done). Only set for the Fixup phase.
 
 		// output
 		void* Destination;
 		ContentState State;
+		uint32 ResidentSize; // how much memory (CPU or GPU) the loaded content holds onto, not counting Destination itself
+		uint32 BytesRead;        // everything OpenAndMap() has opened, for the load telemetry
+		uint32 ReadMicroseconds; // ...and how long that took
+
+		// Loaders should open their files with this instead of FileFinder::OpenAndMap(), so the time spent
+		// reading (and decompressing packed files) is counted separately from the time spent decoding.
+		bool OpenAndMap(const char* filename, FoundFile* result);
+		bool OpenAndMap(StringRef filename, FoundFile* result);
 	};
 
 	struct ContentLoaderData;
@@ -1,423 +1,1810 @@
-#include "ContentManager.h"
-#include "../Gui/GuiManager.h"
-#include "../Graphics/TextureLoader.h"
-#include "../Graphics/Model.h"
-#include "../Utils.h"
-#include "../MemoryManager.h"
-#include "../iniparse.h"
-
-namespace Content
-{
-	enum class LoadState
-	{
-		Free,
-
-		QueuedForLoad,
-		QueuedForFixup,
-		Loaded,
-		QueuedForUnload,
-		Unloaded,
-
-		Error
-	};
-
-	struct ResourceFile
-	{
-		//uint32 NameHash;
-		ResourceType Type;
-		LoadState State;
-		int RefCount;
-
-		void* Data;
-	};
-
-	struct ResourceFileGroup
-	{
-		uint32 NameHash;
-		uint32* FileIndices;
-		uint32 NumFiles;
-	};
-
-	struct ContentManagerData
-	{
-		uint32 Resolution;
-		LocaleCode Language;
-		LocaleCode Region;
-
-		//ResourceFile* Files;
-		uint8* LoaderData;
-		//uint32 NumFiles;
-		//uint32 MaxFiles;
-
-		static const uint32 MaxGroups = 100;
-		ResourceFileGroup Groups[MaxGroups];
-		uint32 NumGroups;
-
-		struct _SubstitutionTable
-		{
-			static const uint32 MaxFiles = 1000;
-			uint32 SourceHash[MaxFiles];
-			uint32 DestHash[MaxFiles];
-			bool Active[MaxFiles];
-		} SubstitutionTable;
-
-		struct _FileHashTable
-		{
-			static const uint32 MaxFiles = 1000;
-			ResourceFile Files[MaxFiles];
-			uint32 Hashes[MaxFiles];
-			StringRef Filenames[MaxFiles];
-			bool Active[MaxFiles];
-		} FileHashTable;
-
-		struct _PreloadTable
-		{
-			uint32 NumFiles;
-			uint32 NumGroups;
-			static const uint32 MaxGroups = 100;
-			struct Group
-			{
-				uint32 Hash;
-				uint32 NumFiles;
-
-				static const uint32 MaxFiles = 1000;
-				struct File
-				{
-					uint32 TrueHash;
-					uint32 BasicHash;
-					uint32 Resolution;
-					LocaleCode Language;
-					LocaleCode Region;
-				} Files[MaxFiles];
-			} Groups[MaxGroups];
-		} PreloadTable;
-	};
-
-	ContentManagerData* ContentManager::m_data = nullptr;
-
-	void ContentManager::SetGlobalData(ContentManagerData** data, Nxna::Graphics::GraphicsDevice* device)
-	{
-		if (*data == nullptr)
-		{
-			*data = (ContentManagerData*)g_memory->AlignedAllocTrack(sizeof(ContentManagerData), alignof(ContentManagerData), __FILE__, __LINE__);
-			memset(*data, 0, sizeof(ContentManagerData));
-		}
-
-		m_data = *data;
-	}
-
-	void cmdReload(const char* arg)
-	{
-		if (ContentManager::ReloadAll() == false)
-		{
-			LOG_ERROR("Fatal error while trying to reload content");
-			exit(-1);
-		}
-	}
-
-	bool ContentManager::Init(uint32 screenHeight, LocaleCode language, LocaleCode region)
-	{
-		m_data->Resolution = screenHeight;
-		m_data->Language = language;
-		m_data->Region = region;
-
-#if 0
-		// look for localized or res-dependant versions of files
-		{
-			char res[6];
-			if (VirtualResolution::InjectNearestResolution("r%", res, 6) == false)
-				return false;
-
-			char locale[6];
-			memcpy(locale, language.Code, 2);
-			if (region.NumericCode != 0)
-			{
-				locale[2] = '-';
-				memcpy(locale + 3, region.Code, 2);
-				locale[5] = 0;
-			}
-				
-			const char* filename;
-			uint32 i = 0;
-			while ((filename = FileSystem::GetFilenameByIndex(i++)) != nullptr)
-			{
-				uint32 originalHash = Utils::CalcHash(filename);
-				
-				uint32 index;
-				if (Utils::HashTableUtils::Reserve(originalHash, m_data->SubstitutionTable.SourceHash, m_data->SubstitutionTable.Active, m_data->SubstitutionTable.MaxFiles, &index) == false)
-						return false;
-				m_data->SubstitutionTable.DestHash[index] = originalHash;
-
-				char buffer[256];
-
-				auto dot = strrchr(filename, '.');
-				auto end = Utils::CopyString(buffer, filename, 256, dot - filename + 1);
-
-				// look for res-dependant
-				Utils::ConcatString(buffer, res, 256);
-				Utils::ConcatString(buffer, dot, 256);
-
-				uint32 hash = Utils::CalcHash(buffer);
-				if (FileSystem::GetFilenameByHash(hash) != nullptr)
-				{
-					// add to the list of substitutions
-					m_data->SubstitutionTable.DestHash[index] = hash;
-				}
-				end[0] = 0;
-
-				// look for localized
-				Utils::ConcatString(buffer, locale, 256);
-				Utils::ConcatString(buffer, dot, 256);
-
-				hash = Utils::CalcHash(buffer);
-				if (FileSystem::GetFilenameByHash(hash) != nullptr)
-				{
-					// add to the list of substitutions
-					m_data->SubstitutionTable.DestHash[index] = hash;
-				}
-				end[0] = 0;
-
-				// look for res-dependant and localized
-				Utils::ConcatString(buffer, res, 256);
-				Utils::ConcatString(buffer, ".", 256);
-				Utils::ConcatString(buffer, locale, 256);
-				Utils::ConcatString(buffer, dot, 256);
-
-				hash = Utils::CalcHash(buffer);
-				if (FileSystem::GetFilenameByHash(hash) != nullptr)
-				{
-					// add to the list of substitutions
-					m_data->SubstitutionTable.DestHash[index] = hash;
-				}
-				end[0] = 0;
-			}
-		}
-#endif
-		// add the "reload" console command
-		ConsoleCommand cmd = {};
-		cmd.Command = "reload";
-		cmd.Callback = cmdReload;
-		Gui::Console::AddCommands(&cmd, 1);
-
-		return true;
-	}
-
-	void ContentManager::Shutdown()
-	{
-		// TODO
-	}
-
-
-	void* ContentManager::Get(StringRef filename, ResourceType type, ContentLoadFlags flags)
-	{
-		uint32 finalIndex;
-
-#if 0
-		// see if we need to look for a substituted (localized or res-dependant) version
-		if ((flags & ContentLoadFlags_DontFixup) == 0)
-		{
-			if (Utils::HashTableUtils::Find(hash, m_data->SubstitutionTable.SourceHash, m_data->SubstitutionTable.Active, m_data->SubstitutionTable.MaxFiles, &finalIndex))
-			{
-				hash = m_data->SubstitutionTable.DestHash[finalIndex];
-			}
-		}
-#endif
-		auto path = HashStringManager::Get(filename, HashStringManager::HashStringType::File);
-		if (path == nullptr) return nullptr;
-
-		auto hash = Utils::CalcHash(path);
-
-		if (Utils::HashTableUtils::Find(hash, m_data->FileHashTable.Hashes, m_data->FileHashTable.Active, m_data->FileHashTable.MaxFiles, &finalIndex))
-		{
-			m_data->FileHashTable.Files[finalIndex].RefCount++;
-			return m_data->FileHashTable.Files[finalIndex].Data;
-		}
-
-		// the file wasn't found, so try to load it
-		if (flags & ContentLoadFlags::ContentLoadFlags_PreloadOnly)
-			return nullptr;
-
-		auto loader = ContentLoader::FindLoader(type);
-
-		uint32 size, alignment;
-		if (GetResourceInfo(type, &size, &alignment) == false)
-			return nullptr;
-
-		uint32 index;
-		if (Utils::HashTableUtils::Reserve(hash, m_data->FileHashTable.Hashes, m_data->FileHashTable.Active, m_data->FileHashTable.MaxFiles, &index) == false)
-			return nullptr;
-
-		m_data->FileHashTable.Filenames[index] = filename;
-		m_data->FileHashTable.Files[index].Data = g_memory->AllocTrack(size, __FILE__, __LINE__);
-
-		if (load(filename, type, loader, index))
-			return m_data->FileHashTable.Files[index].Data;
-
-		// still here? Well, we tried.
-		g_memory->FreeTrack(m_data->FileHashTable.Files[index].Data, __FILE__, __LINE__);
-		m_data->FileHashTable.Active[index] = false;
-
-		return nullptr;
-	}
-
-	void ContentManager::Release(void* content)
-	{
-		/*
-		// NOTE: this is suseptible to the ABA problem. If we really want to be safe we should probably have some kind of ContentHandle.
-
-		// TODO: we could build a hash table to make lookups faster
-
-		for (uint32 i = 0; i < m_data->NumFiles; i++)
-		{
-			if (m_data->Files[i].Data == content)
-			{
-				if (m_data->Files[i].State == LoadState::Loaded ||
-					m_data->Files[i].State == LoadState::Unloaded)
-				{
-					if (m_data->Files[i].RefCount > 0)
-					{
-						m_data->Files[i].RefCount--;
-						return;
-					}
-					else
-					{
-						WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Trying to release content, but no refs were detected");
-						return;
-					}
-				}
-				else
-				{
-					WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Trying to release content, but content isn't loaded");
-					return;
-				}
-			}
-		}
-
-		WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Trying to release content, but content wasn't found");
-		*/
-	}
-
-	bool ContentManager::ReloadAll()
-	{
-		for (uint32 i = 0; i < ContentManagerData::_FileHashTable::MaxFiles; i++)
-		{
-			if (m_data->FileHashTable.Active[i])
-			{
-				auto type = m_data->FileHashTable.Files[i].Type;
-				auto loader = ContentLoader::FindLoader(type);
-
-				if (loader == nullptr)
-				{
-					LOG_ERROR("Unable to find loader for file with hash %u during reload. Ignoring.", m_data->FileHashTable.Hashes[i]);
-					continue;
-				}
-
-				if (loader->UnloaderFunc(m_data->FileHashTable.Files[i].Data) == false)
-				{
-					LOG_ERROR("Unable to unload file with hash %u during reload. Ignoring.", m_data->FileHashTable.Hashes[i]);
-					continue;
-				}
-
-				if (load(m_data->FileHashTable.Filenames[i], type, loader, i) == false)
-				{
-					// uh oh, we can't really recover from this!
-					LOG_ERROR("Unable to reload file with hash %u!", m_data->FileHashTable.Hashes[i]);
-					return false;
-				}
-			}
-		}
-
-		return true;
-	}
-
-	bool ContentManager::GetResourceInfo(ResourceType type, uint32* size, uint32* alignment)
-	{
-		if (size == nullptr || alignment == nullptr)
-			return false;
-
-#ifdef _MSC_VER
-		// make sure all ResourceTypes are explicitly handled
-#pragma warning(push, 4)
-#pragma warning(error: 4061 4062)
-#endif
-		switch (type)
-		{
-		case ResourceType::Cursor:
-		{
-			*size = sizeof(CursorInfo);
-			*alignment = sizeof(CursorInfo);
-			return true;
-		}
-		case ResourceType::Font:
-		{
-			*size = sizeof(Gui::Font);
-			*alignment = alignof(Gui::Font);
-			return true;
-		}
-		case ResourceType::Model:
-		{
-			*size = sizeof(Graphics::Model);
-			*alignment = alignof(Graphics::Model);
-			return true;
-		}
-		case ResourceType::Texture2D:
-		{
-			*size = sizeof(Nxna::Graphics::Texture2D);
-			*alignment = alignof(Nxna::Graphics::Texture2D);
-			return true;
-		}
-		case ResourceType::Bitmap:
-		{
-			*size = sizeof(Graphics::Bitmap);
-			*alignment = alignof(Graphics::Bitmap);
-			return true;
-		}
-		case ResourceType::Audio:
-		{
-			*size = sizeof(Audio::Buffer);
-			*alignment = alignof(Audio::Buffer);
-			return true;
-		}
-		case ResourceType::LAST:
-		{
-			return false;
-		}
-		}
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
-
-		// keep the compiler happy
-		return false;
-	}
-
-	bool ContentManager::load(StringRef filename, ResourceType type, Loader* loader, uint32 destIndex)
-	{
-		ContentLoaderParams p = {};
-		p.Phase = LoaderPhase::AsyncLoad;
-		p.Type = type;
-		p.Destination = m_data->FileHashTable.Files[destIndex].Data;
-		p.FilenameHash = filename;
-		p.LoaderParam = loader->LoaderParam;
-		p.LocalDataStorage = (uint8*)g_memory->AllocTrack(ContentLoaderParams::LocalDataStorageSize, __FILE__, __LINE__);
-
-		if (loader->LoaderFunc(&p))
-		{
-			p.Phase = LoaderPhase::MainThread;
-			if (loader->LoaderFunc(&p))
-			{
-				p.Phase = LoaderPhase::Fixup;
-				m_data->FileHashTable.Files[destIndex].State = LoadState::QueuedForFixup;
-
-				if (loader->LoaderFunc(&p))
-				{
-					m_data->FileHashTable.Files[destIndex].State = LoadState::Loaded;
-					return true;
-				}
-			}
-		}
-
-		m_data->FileHashTable.Files[destIndex].State = LoadState::Error;
-		return false;
-	}
-}
+#include "ContentManager.h"
+#include "../Gui/GuiManager.h"
+#include "../Graphics/TextureLoader.h"
+#include "../Graphics/Model.h"
+#include "../Utils.h"
+#include "../MemoryManager.h"
+#include "../FileWatcher.h"
+#include "../iniparse.h"
+#include <stdio.h>
+
+namespace Content
+{
+	struct ResourceFile
+	{
+		//uint32 NameHash;
+		ResourceType Type;
+		LoadState State;
+		int RefCount;
+		uint16 Generation; // bumped every time the slot's reused, so old handles stop working
+
+		void* Data;
+		JobInfo Job; // the load job, if the file was requested
+
+		uint32 Size; // the resource itself plus whatever its loader says it's holding onto
+
+		// unreferenced files that are still loaded are in a list for their type, oldest first
+		uint32 LruPrev;
+		uint32 LruNext;
+		uint32 ReleasedTime;
+		bool InLru;
+
+		bool Reloading;   // a new version is loading (or waiting for Tick() to swap it in)
+		bool ReloadAgain; // ...and the file changed again after it started
+
+		// each of these has a reference, which gets released when the file's unloaded
+		static const uint32 MaxDependencies = ContentLoaderParams::MaxDependencies;
+		ContentHandle Dependencies[MaxDependencies];
+		uint32 NumDependencies;
+		ContentLoadJob* PendingFixup; // while it's waiting on its dependencies before the Fixup phase
+	};
+
+	// microseconds on ContentManagerData::Clock, or 0 if it didn't happen
+	struct ContentLoadTimings
+	{
+		uint64 Requested;
+		uint64 AsyncStarted;
+		uint64 AsyncFinished;
+		uint64 MainThreadStarted;
+		uint64 MainThreadFinished;
+		uint64 FixupStarted;
+		int32 Thread; // the worker that ran the AsyncLoad phase
+	};
+
+	// Everything a load needs from one phase to the next. Request() copies it into the job, so
+	// Params.LocalDataStorage gets pointed at the job's own copy once the job is running.
+	struct ContentLoadJob
+	{
+		ContentLoaderParams Params;
+		Loader* FileLoader;
+		uint32 Index;
+		uint16 Generation; // the slot's, so a reload can tell if the file got unloaded in the meantime
+		bool AsyncSucceeded;
+		ContentLoadTimings Timings;
+
+		alignas(16) uint8 LocalDataStorage[ContentLoaderParams::LocalDataStorageSize];
+	};
+
+	struct ResourceFileGroup
+	{
+		uint32 NameHash;
+		uint32* FileIndices;
+		uint32 NumFiles;
+	};
+
+	struct ContentManagerData
+	{
+		uint32 Resolution;
+		LocaleCode Language;
+		LocaleCode Region;
+
+		//ResourceFile* Files;
+		uint8* LoaderData;
+		//uint32 NumFiles;
+		//uint32 MaxFiles;
+
+		static const uint32 MaxGroups = 100;
+		ResourceFileGroup Groups[MaxGroups];
+		uint32 NumGroups;
+
+		struct _SubstitutionTable
+		{
+			static const uint32 MaxFiles = 1000;
+			uint32 SourceHash[MaxFiles];
+			uint32 DestHash[MaxFiles];
+			bool Active[MaxFiles];
+		} SubstitutionTable;
+
+		struct _FileHashTable
+		{
+			static const uint32 MaxFiles = 1000;
+			ResourceFile Files[MaxFiles];
+			uint32 Hashes[MaxFiles];
+			StringRef Filenames[MaxFiles];
+			bool Active[MaxFiles];
+		} FileHashTable;
+
+		struct _Cache
+		{
+			static const uint32 None = (uint32)-1;
+			static const uint32 NumTypes = (uint32)ResourceType::LAST;
+
+			uint64 Resident[NumTypes];
+			uint64 Budget[NumTypes];
+			uint32 LruHead[NumTypes];
+			uint32 LruTail[NumTypes];
+			uint32 NextReleasedTime;
+
+			uint32 Hits;
+			uint32 Misses;
+			uint32 Evictions;
+		} Cache;
+
+		// files waiting on their dependencies before their Fixup phase can run
+		struct _PendingFixups
+		{
+			static const uint32 MaxFiles = _FileHashTable::MaxFiles;
+			uint32 Indices[MaxFiles];
+			uint32 NumFiles;
+		} PendingFixups;
+
+		// reloaded files that are ready to be swapped in at the next Tick()
+		struct _Reloads
+		{
+			static const uint32 MaxFiles = _FileHashTable::MaxFiles; // there's only ever one per slot
+			struct Reload
+			{
+				uint32 Index;
+				uint16 Generation;
+				void* Data;
+				uint32 ResidentSize;
+			} Finished[MaxFiles];
+			uint32 NumFinished;
+		} Reloads;
+
+		Utils::Stopwatch Clock; // load telemetry is measured on this
+
+		// the most recent loads, oldest ones get overwritten. Only the main thread touches these.
+		struct _LoadRecords
+		{
+			static const uint32 MaxRecords = 1024;
+			ContentLoadRecord Records[MaxRecords];
+			uint32 NextRecord;
+		} LoadRecords;
+
+		struct _PreloadTable
+		{
+			uint32 NumFiles;
+			uint32 NumGroups;
+			static const uint32 MaxGroups = 100;
+			struct Group
+			{
+				uint32 Hash;
+				uint32 NumFiles;
+
+				static const uint32 MaxFiles = 1000;
+				struct File
+				{
+					StringRef Filename;
+					ResourceType Type;
+					uint32 TrueHash;
+					uint32 BasicHash;
+					uint32 MinResolution;
+					uint32 MaxResolution; // 0 if there's no max
+					LocaleCode Language;  // 0 if the file's for every language
+					LocaleCode Region;
+				} Files[MaxFiles];
+			} Groups[MaxGroups];
+		} PreloadTable;
+
+		// everything that's been preloaded, so PendingLoads() can say how it's going
+		struct _PreloadBatch
+		{
+			static const uint32 MaxFiles = 1000;
+			ContentHandle Handles[MaxFiles];
+			uint32 NumFiles;
+		} PreloadBatch;
+
+		// what the current scene preloaded, so it can be released when the next scene is preloaded
+		struct _ScenePreload
+		{
+			static const uint32 MaxFiles = _PreloadBatch::MaxFiles * 2;
+			ContentHandle Handles[MaxFiles];
+			uint32 NumFiles;
+		} ScenePreload;
+	};
+
+	ContentManagerData* ContentManager::m_data = nullptr;
+
+	void ContentManager::SetGlobalData(ContentManagerData** data, Nxna::Graphics::GraphicsDevice* device)
+	{
+		if (*data == nullptr)
+		{
+			*data = (ContentManagerData*)g_memory->AllocAndKeep(sizeof(ContentManagerData), __FILE__, __LINE__);
+			memset(*data, 0, sizeof(ContentManagerData));
+
+			for (uint32 i = 0; i < ContentManagerData::_Cache::NumTypes; i++)
+			{
+				(*data)->Cache.LruHead[i] = ContentManagerData::_Cache::None;
+				(*data)->Cache.LruTail[i] = ContentManagerData::_Cache::None;
+			}
+
+			(*data)->Clock.Start();
+		}
+
+		m_data = *data;
+	}
+
+	// what memory used while loading (and by the loaded resource) gets counted as
+	MemoryTag getMemoryTag(ResourceType type)
+	{
+		switch (type)
+		{
+		case ResourceType::Texture2D:
+		case ResourceType::Bitmap:
+			return MemoryTag::ContentTexture;
+		case ResourceType::Model:
+			return MemoryTag::ContentModel;
+		case ResourceType::Audio:
+			return MemoryTag::Audio;
+		case ResourceType::Cursor:
+		case ResourceType::Font:
+			return MemoryTag::Gui;
+		default:
+			return MemoryTag::General;
+		}
+	}
+
+	void cmdReload(const char* arg)
+	{
+		uint32 numFiles = ContentManager::ReloadAll();
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "Reloading %u files", numFiles);
+	}
+
+	static const char* getResourceTypeName(ResourceType type)
+	{
+#undef DEFINE_RESOURCE_TYPE
+#define DEFINE_RESOURCE_TYPE(t) #t,
+		static const char* names[] = {
+			DEFINE_RESOURCE_TYPES
+		};
+#undef DEFINE_RESOURCE_TYPE
+
+		return type < ResourceType::LAST ? names[(int)type] : "Unknown";
+	}
+
+	static ResourceType findResourceType(const char* name, const char* nameEnd)
+	{
+		return ContentLoader::GetResourceTypeByNameHash(Utils::CalcHash((const uint8*)name, nameEnd - name));
+	}
+
+	void cmdContentCache(const char* arg)
+	{
+		ContentCacheStats stats;
+		ContentManager::GetCacheStats(&stats);
+
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%u hits, %u misses, %u evictions", stats.Hits, stats.Misses, stats.Evictions);
+
+		for (uint32 i = 0; i < ContentCacheStats::NumTypes; i++)
+		{
+			if (stats.Budget[i] != 0)
+			{
+				WriteLog(stats.Resident[i] > stats.Budget[i] ? LogSeverityType::Warning : LogSeverityType::Normal, LogChannelType::ConsoleOutput,
+					"%-10s %8.2f / %.2f MB, %u loaded (%u unreferenced)", getResourceTypeName((ResourceType)i),
+					stats.Resident[i] / (1024.0f * 1024.0f), stats.Budget[i] / (1024.0f * 1024.0f), stats.NumLoaded[i], stats.NumUnreferenced[i]);
+			}
+			else
+			{
+				WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%-10s %8.2f MB (no budget), %u loaded (%u unreferenced)",
+					getResourceTypeName((ResourceType)i), stats.Resident[i] / (1024.0f * 1024.0f), stats.NumLoaded[i], stats.NumUnreferenced[i]);
+			}
+		}
+	}
+
+	int compareLoadRecords(const void* a, const void* b)
+	{
+		auto ra = (const ContentLoadRecord*)a;
+		auto rb = (const ContentLoadRecord*)b;
+
+		// slowest first
+		if (ra->Total != rb->Total)
+			return ra->Total > rb->Total ? -1 : 1;
+		return 0;
+	}
+
+	// content_stats [how many of the slowest loads to list]
+	void cmdContentStats(const char* arg)
+	{
+		const uint32 maxRecords = ContentManagerData::_LoadRecords::MaxRecords;
+		ContentLoadRecord* records = (ContentLoadRecord*)g_memory->AllocTrack(sizeof(ContentLoadRecord) * maxRecords, __FILE__, __LINE__);
+		uint32 numRecords = ContentManager::GetLoadRecords(records, maxRecords);
+
+		uint64 bytesRead = 0, queued = 0, read = 0, async = 0, waiting = 0, mainThread = 0, dependencies = 0, fixup = 0;
+		for (uint32 i = 0; i < numRecords; i++)
+		{
+			bytesRead += records[i].BytesRead;
+			queued += records[i].Queued;
+			read += records[i].Read;
+			async += records[i].AsyncLoad;
+			waiting += records[i].WaitingForMainThread;
+			mainThread += records[i].MainThread;
+			dependencies += records[i].WaitingForDependencies;
+			fixup += records[i].Fixup;
+		}
+
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%u loads, %.2f MB read. Queued %.2f ms, reading %.2f ms, AsyncLoad %.2f ms, waiting for the main thread %.2f ms, MainThread %.2f ms, waiting for dependencies %.2f ms, Fixup %.2f ms",
+			numRecords, bytesRead / (1024.0f * 1024.0f), queued / 1000.0f, read / 1000.0f, async / 1000.0f, waiting / 1000.0f, mainThread / 1000.0f, dependencies / 1000.0f, fixup / 1000.0f);
+
+		qsort(records, numRecords, sizeof(ContentLoadRecord), compareLoadRecords);
+
+		int count = arg && arg[0] ? atoi(arg) : 10;
+		for (uint32 i = 0; i < numRecords && (int)i < count; i++)
+		{
+			auto r = &records[i];
+			auto filename = HashStringManager::Get(r->Filename, HashStringManager::HashStringType::File);
+
+			WriteLog(r->Succeeded ? LogSeverityType::Normal : LogSeverityType::Warning, LogChannelType::ConsoleOutput,
+				"%8.2f ms %-10s %s%s: %u KB, read %.2f, async %.2f, main thread %.2f, dependencies %.2f, fixup %.2f ms (worker %d)",
+				r->Total / 1000.0f, getResourceTypeName(r->Type), filename ? filename : "(unknown)", r->Reload ? " (reload)" : "",
+				r->BytesRead / 1024, r->Read / 1000.0f, r->AsyncLoad / 1000.0f, r->MainThread / 1000.0f, r->WaitingForDependencies / 1000.0f, r->Fixup / 1000.0f, r->Thread);
+		}
+
+		g_memory->FreeTrack(records, __FILE__, __LINE__);
+	}
+
+	void cmdContentStatsDump(const char* arg)
+	{
+		const char* filename = arg && arg[0] ? arg : "contentstats.csv";
+
+		if (ContentManager::WriteLoadRecords(filename))
+			WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "Wrote content load stats to %s", filename);
+		else
+			WriteLog(LogSeverityType::Error, LogChannelType::ConsoleOutput, "Unable to write content load stats to %s", filename);
+	}
+
+	// content_budget <type> <MB>
+	void cmdContentBudget(const char* arg)
+	{
+		const char* nameEnd = arg;
+		while (*nameEnd != ' ' && *nameEnd != 0) nameEnd++;
+
+		auto type = findResourceType(arg, nameEnd);
+		if (type == ResourceType::LAST || *nameEnd == 0)
+		{
+			WriteLog(LogSeverityType::Error, LogChannelType::ConsoleOutput, "Usage: content_budget <type> <MB>");
+			return;
+		}
+
+		float megabytes = strtof(nameEnd, nullptr);
+		ContentManager::SetCacheBudget(type, (uint32)(megabytes * 1024 * 1024));
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%s cache budget is now %.2f MB", getResourceTypeName(type), megabytes);
+	}
+
+	bool ContentManager::Init(uint32 screenHeight, LocaleCode language, LocaleCode region)
+	{
+		m_data->Resolution = screenHeight;
+		m_data->Language = language;
+		m_data->Region = region;
+
+#if 0
+		// look for localized or res-dependant versions of files
+		{
+			char res[6];
+			if (VirtualResolution::InjectNearestResolution("r%", res, 6) == false)
+				return false;
+
+			char locale[6];
+			memcpy(locale, language.Code, 2);
+			if (region.NumericCode != 0)
+			{
+				locale[2] = '-';
+				memcpy(locale + 3, region.Code, 2);
+				locale[5] = 0;
+			}
+				
+			const char* filename;
+			uint32 i = 0;
+			while ((filename = FileSystem::GetFilenameByIndex(i++)) != nullptr)
+			{
+				uint32 originalHash = Utils::CalcHash(filename);
+				
+				uint32 index;
+				if (Utils::HashTableUtils::Reserve(originalHash, m_data->SubstitutionTable.SourceHash, m_data->SubstitutionTable.Active, m_data->SubstitutionTable.MaxFiles, &index) == false)
+						return false;
+				m_data->SubstitutionTable.DestHash[index] = originalHash;
+
+				char buffer[256];
+
+				auto dot = strrchr(filename, '.');
+				auto end = Utils::CopyString(buffer, filename, 256, dot - filename + 1);
+
+				// look for res-dependant
+				Utils::ConcatString(buffer, res, 256);
+				Utils::ConcatString(buffer, dot, 256);
+
+				uint32 hash = Utils::CalcHash(buffer);
+				if (FileSystem::GetFilenameByHash(hash) != nullptr)
+				{
+					// add to the list of substitutions
+					m_data->SubstitutionTable.DestHash[index] = hash;
+				}
+				end[0] = 0;
+
+				// look for localized
+				Utils::ConcatString(buffer, locale, 256);
+				Utils::ConcatString(buffer, dot, 256);
+
+				hash = Utils::CalcHash(buffer);
+				if (FileSystem::GetFilenameByHash(hash) != nullptr)
+				{
+					// add to the list of substitutions
+					m_data->SubstitutionTable.DestHash[index] = hash;
+				}
+				end[0] = 0;
+
+				// look for res-dependant and localized
+				Utils::ConcatString(buffer, res, 256);
+				Utils::ConcatString(buffer, ".", 256);
+				Utils::ConcatString(buffer, locale, 256);
+				Utils::ConcatString(buffer, dot, 256);
+
+				hash = Utils::CalcHash(buffer);
+				if (FileSystem::GetFilenameByHash(hash) != nullptr)
+				{
+					// add to the list of substitutions
+					m_data->SubstitutionTable.DestHash[index] = hash;
+				}
+				end[0] = 0;
+			}
+		}
+#endif
+		ConsoleCommand cmd[] = {
+			{ "reload", cmdReload },
+			{ "content_cache", cmdContentCache },
+			{ "content_budget", cmdContentBudget },
+			{ "content_stats", cmdContentStats },
+			{ "content_stats_dump", cmdContentStatsDump }
+		};
+		Gui::Console::AddCommands(cmd, 5);
+
+		loadCacheBudgets("budgets.txt");
+
+		return loadManifest("manifest.txt");
+	}
+
+	void ContentManager::Shutdown()
+	{
+		// TODO
+	}
+
+
+	int ContentManager::PreloadGlobal()
+	{
+		return preload(Utils::CalcHash("global"), ContentLoadFlags::ContentLoadFlags_None);
+	}
+
+	int ContentManager::PreloadScene(uint32 sceneID)
+	{
+		return preload(sceneID, ContentLoadFlags::ContentLoadFlags_Scene);
+	}
+
+	bool ContentManager::PendingLoads(uint32* numLoaded, uint32* numErrors, uint32* numTotal)
+	{
+		// callers loop on this with just JobQueue::Tick(), so it has to finish anything that was waiting on its dependencies
+		runReadyFixups();
+
+		uint32 loaded = 0, errors = 0;
+		for (uint32 i = 0; i < m_data->PreloadBatch.NumFiles; i++)
+		{
+			auto state = GetState(m_data->PreloadBatch.Handles[i]);
+			if (state == LoadState::Loaded)
+				loaded++;
+			else if (state == LoadState::Error || state == LoadState::Free)
+				errors++;
+		}
+
+		if (numLoaded) *numLoaded = loaded;
+		if (numErrors) *numErrors = errors;
+		if (numTotal) *numTotal = m_data->PreloadBatch.NumFiles;
+
+		return loaded + errors < m_data->PreloadBatch.NumFiles;
+	}
+
+	ContentHandle ContentManager::Request(StringRef filename, ResourceType type, ContentLoadFlags flags, JobPriority priority)
+	{
+		uint32 hash, index;
+		if (hashFilename(filename, &hash) == false)
+			return INVALID_CONTENT;
+
+		if (find(hash, &index))
+		{
+			addRef(index);
+			m_data->Cache.Hits++;
+			return getHandle(index);
+		}
+
+		if (flags & ContentLoadFlags::ContentLoadFlags_PreloadOnly)
+			return INVALID_CONTENT;
+
+		if (reserve(filename, hash, type, &index) == false)
+			return INVALID_CONTENT;
+		m_data->Cache.Misses++;
+
+		queueLoad(index, priority);
+
+		return getHandle(index);
+	}
+
+	void ContentManager::Tick()
+	{
+		FileWatcher::Poll(fileChanged);
+
+		runReadyFixups();
+
+		// everything that's finished reloading gets swapped in here at once, so a frame never sees half of a change
+		auto reloads = &m_data->Reloads;
+		for (uint32 i = 0; i < reloads->NumFinished; i++)
+		{
+			auto finished = &reloads->Finished[i];
+			ResourceFile* file = &m_data->FileHashTable.Files[finished->Index];
+			auto loader = ContentLoader::FindLoader(file->Type);
+
+			uint32 size, alignment;
+			GetResourceInfo(file->Type, &size, &alignment);
+
+			MemoryTagScope tag(getMemoryTag(file->Type));
+
+			ContentLoaderParams params = {};
+			params.Type = file->Type;
+			params.FilenameHash = m_data->FileHashTable.Filenames[finished->Index];
+			params.LoaderParam = loader->LoaderParam;
+
+			// it might have been unloaded since the new version finished (or the old one might refuse to go)
+			params.Destination = file->Data;
+			bool stillLoaded = m_data->FileHashTable.Active[finished->Index] && file->Generation == finished->Generation;
+			if (stillLoaded == false || loader->UnloaderFunc(&params) == false)
+			{
+				if (stillLoaded)
+				{
+					LOG_ERROR("Unable to unload file with hash %u to replace it. Keeping the old version.", m_data->FileHashTable.Hashes[finished->Index]);
+					file->Reloading = false;
+				}
+
+				params.Destination = finished->Data;
+				loader->UnloaderFunc(&params);
+				g_memory->FreeTrack(finished->Data, __FILE__, __LINE__);
+				continue;
+			}
+
+			memcpy(file->Data, finished->Data, size);
+			g_memory->FreeTrack(finished->Data, __FILE__, __LINE__);
+
+			m_data->Cache.Resident[(int)file->Type] -= file->Size;
+			file->Size = size + finished->ResidentSize;
+			m_data->Cache.Resident[(int)file->Type] += file->Size;
+			file->Reloading = false;
+
+			WriteLog(LogSeverityType::Normal, LogChannelType::Content, "Reloaded %s", HashStringManager::Get(params.FilenameHash, HashStringManager::HashStringType::File));
+
+			if (file->ReloadAgain)
+			{
+				file->ReloadAgain = false;
+				queueReload(finished->Index);
+			}
+
+			trim(file->Type);
+		}
+
+		reloads->NumFinished = 0;
+	}
+
+	LoadState ContentManager::GetState(ContentHandle handle)
+	{
+		uint32 index;
+		if (getIndex(handle, &index) == false)
+			return LoadState::Free;
+
+		auto state = m_data->FileHashTable.Files[index].State;
+		if (state == LoadState::Loaded && dependenciesLoading(index, 0))
+			return LoadState::QueuedForLoad;
+
+		return state;
+	}
+
+	void* ContentManager::GetData(ContentHandle handle)
+	{
+		uint32 index;
+		if (getIndex(handle, &index) == false || m_data->FileHashTable.Files[index].State != LoadState::Loaded)
+			return nullptr;
+
+		return m_data->FileHashTable.Files[index].Data;
+	}
+
+	void* ContentManager::Wait(ContentHandle handle)
+	{
+		uint32 index;
+		if (getIndex(handle, &index) == false)
+			return nullptr;
+
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+
+		// anything that's still queued has a job, since everything else gets loaded right away
+		if (file->State == LoadState::QueuedForLoad)
+			JobQueue::WaitForJob(&file->Job);
+
+		// the dependencies are all loading at once, so the order doesn't matter
+		for (uint32 i = 0; i < file->NumDependencies; i++)
+			Wait(file->Dependencies[i]);
+
+		if (file->PendingFixup != nullptr)
+			runPendingFixup(index);
+
+		return GetData(handle);
+	}
+
+	ContentHandle ContentManager::AddDependency(ContentHandle content, StringRef filename, ResourceType type)
+	{
+		uint32 index;
+		if (getIndex(content, &index) == false)
+			return INVALID_CONTENT;
+
+		return addDependency(index, filename, type);
+	}
+
+	void* ContentManager::Get(StringRef filename, ResourceType type, ContentLoadFlags flags)
+	{
+#if 0
+		uint32 finalIndex;
+
+		// see if we need to look for a substituted (localized or res-dependant) version
+		if ((flags & ContentLoadFlags_DontFixup) == 0)
+		{
+			if (Utils::HashTableUtils::Find(hash, m_data->SubstitutionTable.SourceHash, m_data->SubstitutionTable.Active, m_data->SubstitutionTable.MaxFiles, &finalIndex))
+			{
+				hash = m_data->SubstitutionTable.DestHash[finalIndex];
+			}
+		}
+#endif
+		uint32 hash, index;
+		if (hashFilename(filename, &hash) == false)
+			return nullptr;
+
+		if (find(hash, &index))
+		{
+			addRef(index);
+			m_data->Cache.Hits++;
+			return Wait(getHandle(index));
+		}
+
+		// the file wasn't found, so try to load it
+		if (flags & ContentLoadFlags::ContentLoadFlags_PreloadOnly)
+			return nullptr;
+
+		if (reserve(filename, hash, type, &index) == false)
+			return nullptr;
+		m_data->Cache.Misses++;
+
+		// the caller is going to wait for it anyway, so skip the job queue (though its dependencies still use it)
+		if (load(filename, type, ContentLoader::FindLoader(type), index))
+			return Wait(getHandle(index));
+
+		// still here? Well, we tried.
+		return nullptr;
+	}
+
+	void ContentManager::Release(ContentHandle handle)
+	{
+		if (handle == INVALID_CONTENT)
+			return;
+
+		uint32 index;
+		if (getIndex(handle, &index) == false)
+		{
+			WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Trying to release content, but content wasn't found");
+			return;
+		}
+
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		if (file->RefCount <= 0)
+		{
+			WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Trying to release content, but no refs were detected");
+			return;
+		}
+
+		file->RefCount--;
+		if (file->RefCount > 0)
+			return;
+
+		if (file->State == LoadState::Loaded)
+		{
+			lruAdd(index);
+			trim(file->Type);
+		}
+		else if (file->State == LoadState::Error)
+		{
+			// there's nothing loaded, so nothing worth keeping around
+			m_data->FileHashTable.Active[index] = false;
+			file->State = LoadState::Free;
+		}
+
+		// anything that's still loading goes in the LRU list once it's done
+	}
+
+	void ContentManager::SetCacheBudget(ResourceType type, uint32 bytes)
+	{
+		if (type >= ResourceType::LAST)
+			return;
+
+		m_data->Cache.Budget[(int)type] = bytes;
+		trim(type);
+	}
+
+	void ContentManager::GetCacheStats(ContentCacheStats* result)
+	{
+		memset(result, 0, sizeof(ContentCacheStats));
+		result->Hits = m_data->Cache.Hits;
+		result->Misses = m_data->Cache.Misses;
+		result->Evictions = m_data->Cache.Evictions;
+
+		for (uint32 i = 0; i < ContentCacheStats::NumTypes; i++)
+		{
+			result->Resident[i] = m_data->Cache.Resident[i];
+			result->Budget[i] = m_data->Cache.Budget[i];
+		}
+
+		for (uint32 i = 0; i < ContentManagerData::_FileHashTable::MaxFiles; i++)
+		{
+			ResourceFile* file = &m_data->FileHashTable.Files[i];
+			if (m_data->FileHashTable.Active[i] && file->State == LoadState::Loaded)
+			{
+				result->NumLoaded[(int)file->Type]++;
+				if (file->InLru)
+					result->NumUnreferenced[(int)file->Type]++;
+			}
+		}
+	}
+
+	uint32 ContentManager::ReloadAll()
+	{
+		uint32 numFiles = 0;
+		for (uint32 i = 0; i < ContentManagerData::_FileHashTable::MaxFiles; i++)
+		{
+			if (m_data->FileHashTable.Active[i] && queueReload(i))
+				numFiles++;
+		}
+
+		return numFiles;
+	}
+
+	uint32 ContentManager::GetLoadRecords(ContentLoadRecord* records, uint32 maxRecords)
+	{
+		auto log = &m_data->LoadRecords;
+
+		uint32 end = log->NextRecord;
+		uint32 count = end < log->MaxRecords ? end : log->MaxRecords;
+		if (count > maxRecords)
+			count = maxRecords;
+
+		for (uint32 i = 0; i < count; i++)
+			records[i] = log->Records[(end - count + i) % log->MaxRecords];
+
+		return count;
+	}
+
+	// Gets text ready to go between quotes in a json or csv file. Windows puts \ in paths, which aren't legal in
+	// json without escaping them, so they're replaced with /.
+	static void escapeString(char* destination, uint32 destLength, const char* text, bool json)
+	{
+		uint32 length = 0;
+		for (const char* c = text; *c != 0 && length + 2 < destLength; c++)
+		{
+			if (*c == '"')
+				destination[length++] = json ? '\\' : '"';
+
+			if (json && *c == '\\')
+				destination[length++] = '/';
+			else if ((unsigned char)*c >= ' ')
+				destination[length++] = *c;
+		}
+		destination[length] = 0;
+	}
+
+	bool ContentManager::WriteLoadRecords(const char* filename)
+	{
+		FILE* fp;
+#ifdef _WIN32
+		if (fopen_s(&fp, filename, "w") != 0)
+			fp = nullptr;
+#else
+		fp = fopen(filename, "w");
+#endif
+		if (fp == nullptr)
+			return false;
+
+		const uint32 maxRecords = ContentManagerData::_LoadRecords::MaxRecords;
+		ContentLoadRecord* records = (ContentLoadRecord*)g_memory->AllocTrack(sizeof(ContentLoadRecord) * maxRecords, __FILE__, __LINE__);
+		uint32 numRecords = GetLoadRecords(records, maxRecords);
+
+		size_t length = strlen(filename);
+		bool json = length >= 5 && strcmp(filename + length - 5, ".json") == 0;
+
+		if (json)
+			fprintf(fp, "[");
+		else
+			fprintf(fp, "filename,type,succeeded,reload,thread,bytesRead,queuedUs,readUs,asyncLoadUs,waitingForMainThreadUs,mainThreadUs,waitingForDependenciesUs,fixupUs,totalUs\n");
+
+		for (uint32 i = 0; i < numRecords; i++)
+		{
+			auto r = &records[i];
+			auto path = HashStringManager::Get(r->Filename, HashStringManager::HashStringType::File);
+			char name[512];
+			escapeString(name, sizeof(name), path ? path : "", json);
+
+			if (json)
+			{
+				fprintf(fp, "%s\n{\"filename\":\"%s\",\"type\":\"%s\",\"succeeded\":%s,\"reload\":%s,\"thread\":%d,\"bytesRead\":%u,"
+					"\"queuedUs\":%u,\"readUs\":%u,\"asyncLoadUs\":%u,\"waitingForMainThreadUs\":%u,\"mainThreadUs\":%u,\"waitingForDependenciesUs\":%u,\"fixupUs\":%u,\"totalUs\":%u}",
+					i > 0 ? "," : "", name, getResourceTypeName(r->Type), r->Succeeded ? "true" : "false", r->Reload ? "true" : "false", r->Thread, r->BytesRead,
+					r->Queued, r->Read, r->AsyncLoad, r->WaitingForMainThread, r->MainThread, r->WaitingForDependencies, r->Fixup, r->Total);
+			}
+			else
+			{
+				fprintf(fp, "\"%s\",%s,%d,%d,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+					name, getResourceTypeName(r->Type), r->Succeeded ? 1 : 0, r->Reload ? 1 : 0, r->Thread, r->BytesRead,
+					r->Queued, r->Read, r->AsyncLoad, r->WaitingForMainThread, r->MainThread, r->WaitingForDependencies, r->Fixup, r->Total);
+			}
+		}
+
+		if (json)
+			fprintf(fp, "\n]\n");
+
+		fclose(fp);
+
+		g_memory->FreeTrack(records, __FILE__, __LINE__);
+
+		return true;
+	}
+
+	bool ContentManager::GetResourceInfo(ResourceType type, uint32* size, uint32* alignment)
+	{
+		if (size == nullptr || alignment == nullptr)
+			return false;
+
+#ifdef _MSC_VER
+		// make sure all ResourceTypes are explicitly handled
+#pragma warning(push, 4)
+#pragma warning(error: 4061 4062)
+#endif
+		switch (type)
+		{
+		case ResourceType::Cursor:
+		{
+			*size = sizeof(CursorInfo);
+			*alignment = sizeof(CursorInfo);
+			return true;
+		}
+		case ResourceType::Font:
+		{
+			*size = sizeof(Gui::Font);
+			*alignment = alignof(Gui::Font);
+			return true;
+		}
+		case ResourceType::Model:
+		{
+			*size = sizeof(Graphics::Model);
+			*alignment = alignof(Graphics::Model);
+			return true;
+		}
+		case ResourceType::Texture2D:
+		{
+			*size = sizeof(Nxna::Graphics::Texture2D);
+			*alignment = alignof(Nxna::Graphics::Texture2D);
+			return true;
+		}
+		case ResourceType::Bitmap:
+		{
+			*size = sizeof(Graphics::Bitmap);
+			*alignment = alignof(Graphics::Bitmap);
+			return true;
+		}
+		case ResourceType::Audio:
+		{
+			*size = sizeof(Audio::Buffer);
+			*alignment = alignof(Audio::Buffer);
+			return true;
+		}
+		case ResourceType::LAST:
+		{
+			return false;
+		}
+		}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+		// keep the compiler happy
+		return false;
+	}
+
+	// The manifest is a list of [group] sections, each with a name, an optional minResolution/maxResolution/language/region,
+	// and a "file: <path>, <ResourceType>" line for each file. Sections with the same name all go in the same group.
+	bool ContentManager::loadManifest(const char* filename)
+	{
+		FoundFile f;
+		if (FileFinder::OpenAndMap(filename, &f) == false)
+			return false;
+
+		auto table = &m_data->PreloadTable;
+		table->NumGroups = 0;
+		table->NumFiles = 0;
+
+		ini_context ctx;
+		ini_item item;
+		ini_init(&ctx, (const char*)f.Memory, (const char*)f.Memory + f.FileSize);
+
+		while (ini_next(&ctx, &item) == ini_result_success)
+		{
+			if (item.type != ini_itemtype::section || ini_section_equals(&ctx, &item, "group") == false)
+				continue;
+
+			// the files come before the name sometimes, so the group has to be figured out afterwards
+			static const uint32 MaxSectionFiles = 256;
+			int fileStart[MaxSectionFiles], fileEnd[MaxSectionFiles];
+			uint32 numFiles = 0, numSkipped = 0;
+			uint32 nameHash = 0;
+			int minResolution = 0, maxResolution = 0;
+			uint16 language = 0, region = 0;
+
+			while (ini_next_within_section(&ctx, &item) == ini_result_success)
+			{
+				if (ini_key_equals(&ctx, &item, "name"))
+					nameHash = Utils::CalcHash((const uint8*)ctx.source + item.keyvalue.value_start, item.keyvalue.value_end - item.keyvalue.value_start);
+				else if (ini_key_equals(&ctx, &item, "minResolution"))
+					ini_value_int(&ctx, &item, &minResolution);
+				else if (ini_key_equals(&ctx, &item, "maxResolution"))
+					ini_value_int(&ctx, &item, &maxResolution);
+				else if (ini_key_equals(&ctx, &item, "language") && item.keyvalue.value_end - item.keyvalue.value_start == 2)
+					memcpy(&language, ctx.source + item.keyvalue.value_start, 2);
+				else if (ini_key_equals(&ctx, &item, "region") && item.keyvalue.value_end - item.keyvalue.value_start == 2)
+					memcpy(&region, ctx.source + item.keyvalue.value_start, 2);
+				else if (ini_key_equals(&ctx, &item, "file"))
+				{
+					if (numFiles == MaxSectionFiles)
+					{
+						numSkipped++;
+						continue;
+					}
+
+					fileStart[numFiles] = item.keyvalue.value_start;
+					fileEnd[numFiles] = item.keyvalue.value_end;
+					numFiles++;
+				}
+			}
+
+			if (numSkipped > 0)
+				WriteLog(LogSeverityType::Error, LogChannelType::Content, "Too many files in a group section in %s, skipping %u of them", filename, numSkipped);
+
+			uint32 groupIndex = 0;
+			while (groupIndex < table->NumGroups && table->Groups[groupIndex].Hash != nameHash)
+				groupIndex++;
+
+			if (groupIndex == table->NumGroups)
+			{
+				if (table->NumGroups == table->MaxGroups)
+				{
+					WriteLog(LogSeverityType::Error, LogChannelType::Content, "Too many groups in %s", filename);
+					break;
+				}
+
+				table->Groups[groupIndex].Hash = nameHash;
+				table->Groups[groupIndex].NumFiles = 0;
+				table->NumGroups++;
+			}
+
+			auto group = &table->Groups[groupIndex];
+
+			for (uint32 i = 0; i < numFiles; i++)
+			{
+				// "path, type" where the type is optional
+				const char* path = ctx.source + fileStart[i];
+				const char* end = ctx.source + fileEnd[i];
+				const char* pathEnd = path;
+				while (pathEnd < end && *pathEnd != ',') pathEnd++;
+
+				const char* typeName = pathEnd < end ? pathEnd + 1 : end;
+				while (typeName < end && *typeName == ' ') typeName++;
+				while (pathEnd > path && pathEnd[-1] == ' ') pathEnd--;
+
+				auto type = typeName < end ?
+					ContentLoader::GetResourceTypeByNameHash(Utils::CalcHash((const uint8*)typeName, end - typeName)) :
+					ContentLoader::GetResourceTypeByFilename(path, pathEnd);
+				if (type == ResourceType::LAST)
+				{
+					WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Unable to figure out the type of manifest file %.*s", (int)(pathEnd - path), path);
+					continue;
+				}
+
+				if (group->NumFiles == group->MaxFiles)
+				{
+					WriteLog(LogSeverityType::Error, LogChannelType::Content, "Too many files in a group in %s", filename);
+					break;
+				}
+
+				auto file = &group->Files[group->NumFiles];
+				file->Filename = HashStringManager::Set(HashStringManager::HashStringType::File, path, pathEnd);
+				file->Type = type;
+				file->TrueHash = Utils::CalcHash((const uint8*)path, pathEnd - path);
+				file->BasicHash = file->TrueHash;
+				file->MinResolution = (uint32)minResolution;
+				file->MaxResolution = (uint32)maxResolution;
+				file->Language.NumericCode = language;
+				file->Region.NumericCode = region;
+
+				group->NumFiles++;
+				table->NumFiles++;
+			}
+		}
+
+		FileFinder::Close(&f);
+
+		return true;
+	}
+
+	// The budget file's [cache] sections each have a "type" (a ResourceType) and a "budget" in MB.
+	// Anything else in the file is for MemoryBudgets.
+	void ContentManager::loadCacheBudgets(const char* filename)
+	{
+		FoundFile f;
+		if (FileFinder::OpenAndMap(filename, &f) == false)
+			return;
+
+		ini_context ctx;
+		ini_item item;
+		ini_init(&ctx, (const char*)f.Memory, (const char*)f.Memory + f.FileSize);
+
+		while (ini_next(&ctx, &item) == ini_result_success)
+		{
+			if (item.type != ini_itemtype::section || ini_section_equals(&ctx, &item, "cache") == false)
+				continue;
+
+			auto type = ResourceType::LAST;
+			float budget = 0;
+
+			while (ini_next_within_section(&ctx, &item) == ini_result_success)
+			{
+				if (ini_key_equals(&ctx, &item, "type"))
+					type = findResourceType(ctx.source + item.keyvalue.value_start, ctx.source + item.keyvalue.value_end);
+				else if (ini_key_equals(&ctx, &item, "budget"))
+					ini_value_float(&ctx, &item, &budget);
+			}
+
+			if (type != ResourceType::LAST)
+				m_data->Cache.Budget[(int)type] = (uint64)(budget * 1024 * 1024);
+			else
+				WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Ignoring a cache budget in %s without a valid type", filename);
+		}
+
+		FileFinder::Close(&f);
+	}
+
+	int ContentManager::preload(uint32 groupHash, ContentLoadFlags flags)
+	{
+		auto table = &m_data->PreloadTable;
+
+		uint32 groupIndex = 0;
+		while (groupIndex < table->NumGroups && table->Groups[groupIndex].Hash != groupHash)
+			groupIndex++;
+
+		if (groupIndex == table->NumGroups)
+			return -1;
+
+		// forget about earlier preloads once they're all done, so the progress is just for this batch
+		auto batch = &m_data->PreloadBatch;
+		if (PendingLoads(nullptr, nullptr, nullptr) == false)
+			batch->NumFiles = 0;
+
+		auto group = &table->Groups[groupIndex];
+
+		// the new scene's files get added after the old ones, so anything they share never drops to 0 refs in between
+		auto scene = &m_data->ScenePreload;
+		uint32 numOldSceneFiles = scene->NumFiles;
+
+		int numRequested = 0;
+		for (uint32 i = 0; i < group->NumFiles; i++)
+		{
+			auto file = &group->Files[i];
+
+			// the max is exclusive, so a file can say it's for everything below the next group's min
+			if (m_data->Resolution < file->MinResolution ||
+				(file->MaxResolution != 0 && m_data->Resolution >= file->MaxResolution))
+				continue;
+			if ((file->Language.NumericCode != 0 && file->Language.NumericCode != m_data->Language.NumericCode) ||
+				(file->Region.NumericCode != 0 && file->Region.NumericCode != m_data->Region.NumericCode))
+				continue;
+
+			if (batch->NumFiles == batch->MaxFiles)
+			{
+				WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Too many files are being preloaded at once. The rest will load when they're needed.");
+				break;
+			}
+
+			auto handle = Request(file->Filename, file->Type, flags);
+			if (handle == INVALID_CONTENT)
+			{
+				WriteLog(LogSeverityType::Error, LogChannelType::Content, "Unable to preload file with hash %u", file->TrueHash);
+				continue;
+			}
+
+			batch->Handles[batch->NumFiles++] = handle;
+			numRequested++;
+
+			if (flags & ContentLoadFlags::ContentLoadFlags_Scene)
+			{
+				// neither scene can preload more than a batch's worth, so there's always room
+				scene->Handles[scene->NumFiles++] = handle;
+			}
+		}
+
+		if (flags & ContentLoadFlags::ContentLoadFlags_Scene)
+		{
+			for (uint32 i = 0; i < numOldSceneFiles; i++)
+				Release(scene->Handles[i]);
+
+			memmove(scene->Handles, scene->Handles + numOldSceneFiles, sizeof(ContentHandle) * (scene->NumFiles - numOldSceneFiles));
+			scene->NumFiles -= numOldSceneFiles;
+		}
+
+		return numRequested;
+	}
+
+	bool ContentManager::hashFilename(StringRef filename, uint32* hash)
+	{
+		auto path = HashStringManager::Get(filename, HashStringManager::HashStringType::File);
+		if (path == nullptr) return false;
+
+		*hash = Utils::CalcHash(path);
+		return true;
+	}
+
+	bool ContentManager::find(uint32 hash, uint32* index)
+	{
+		return Utils::HashTableUtils::Find(hash, m_data->FileHashTable.Hashes, m_data->FileHashTable.Active, m_data->FileHashTable.MaxFiles, index);
+	}
+
+	bool ContentManager::reserve(StringRef filename, uint32 hash, ResourceType type, uint32* index)
+	{
+		if (ContentLoader::FindLoader(type) == nullptr)
+			return false;
+
+		uint32 size, alignment;
+		if (GetResourceInfo(type, &size, &alignment) == false)
+			return false;
+
+		// if the table's full, make room by unloading whatever's gone the longest without being used
+		while (Utils::HashTableUtils::Reserve(hash, m_data->FileHashTable.Hashes, m_data->FileHashTable.Active, m_data->FileHashTable.MaxFiles, index) == false)
+		{
+			if (evictOldest() == false)
+			{
+				WriteLog(LogSeverityType::Error, LogChannelType::Content, "Too many files are loaded (and they're all being used)");
+				return false;
+			}
+		}
+
+		MemoryTagScope tag(getMemoryTag(type));
+
+		ResourceFile* file = &m_data->FileHashTable.Files[*index];
+		file->Type = type;
+		file->State = LoadState::QueuedForLoad;
+		file->RefCount = 1;
+		file->Generation++;
+		file->Size = 0;
+		file->InLru = false;
+		file->Reloading = false;
+		file->ReloadAgain = false;
+		file->NumDependencies = 0;
+		file->PendingFixup = nullptr;
+		file->Data = g_memory->AllocTrack(size, __FILE__, __LINE__);
+		m_data->FileHashTable.Filenames[*index] = filename;
+
+		return true;
+	}
+
+	bool ContentManager::getIndex(ContentHandle handle, uint32* index)
+	{
+		uint32 i = handle & 0xffff;
+		if (handle == INVALID_CONTENT || i >= ContentManagerData::_FileHashTable::MaxFiles ||
+			m_data->FileHashTable.Active[i] == false || m_data->FileHashTable.Files[i].Generation != (uint16)(handle >> 16))
+			return false;
+
+		*index = i;
+		return true;
+	}
+
+	ContentHandle ContentManager::getHandle(uint32 index)
+	{
+		return ((uint32)m_data->FileHashTable.Files[index].Generation << 16) | index;
+	}
+
+	void ContentManager::addRef(uint32 index)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		if (file->InLru)
+			lruRemove(index);
+
+		file->RefCount++;
+	}
+
+	void ContentManager::lruAdd(uint32 index)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		auto cache = &m_data->Cache;
+		uint32 type = (uint32)file->Type;
+
+		// there's no point keeping track of things that can't be unloaded
+		auto loader = ContentLoader::FindLoader(file->Type);
+		if (file->InLru || loader == nullptr || loader->UnloaderFunc == nullptr)
+			return;
+
+		file->LruPrev = cache->LruTail[type];
+		file->LruNext = ContentManagerData::_Cache::None;
+		file->ReleasedTime = cache->NextReleasedTime++;
+		file->InLru = true;
+
+		if (cache->LruTail[type] != ContentManagerData::_Cache::None)
+			m_data->FileHashTable.Files[cache->LruTail[type]].LruNext = index;
+		else
+			cache->LruHead[type] = index;
+		cache->LruTail[type] = index;
+	}
+
+	void ContentManager::lruRemove(uint32 index)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		auto cache = &m_data->Cache;
+		uint32 type = (uint32)file->Type;
+
+		if (file->LruPrev != ContentManagerData::_Cache::None)
+			m_data->FileHashTable.Files[file->LruPrev].LruNext = file->LruNext;
+		else
+			cache->LruHead[type] = file->LruNext;
+
+		if (file->LruNext != ContentManagerData::_Cache::None)
+			m_data->FileHashTable.Files[file->LruNext].LruPrev = file->LruPrev;
+		else
+			cache->LruTail[type] = file->LruPrev;
+
+		file->InLru = false;
+	}
+
+	// Only for files nobody's using anymore! Frees the slot too, so handles to it stop working.
+	bool ContentManager::unload(uint32 index)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		auto loader = ContentLoader::FindLoader(file->Type);
+
+		ContentLoaderParams params = {};
+		params.Type = file->Type;
+		params.Destination = file->Data;
+		params.FilenameHash = m_data->FileHashTable.Filenames[index];
+		params.LoaderParam = loader->LoaderParam;
+
+		MemoryTagScope tag(getMemoryTag(file->Type));
+		if (loader->UnloaderFunc(&params) == false)
+		{
+			WriteLog(LogSeverityType::Error, LogChannelType::Content, "Unable to unload file with hash %u", m_data->FileHashTable.Hashes[index]);
+			return false;
+		}
+
+		if (file->InLru)
+			lruRemove(index);
+
+		releaseDependencies(index);
+
+		m_data->Cache.Resident[(int)file->Type] -= file->Size;
+		g_memory->FreeTrack(file->Data, __FILE__, __LINE__);
+		file->Data = nullptr;
+		file->State = LoadState::Free;
+		m_data->FileHashTable.Active[index] = false;
+
+		return true;
+	}
+
+	void ContentManager::trim(ResourceType type)
+	{
+		auto cache = &m_data->Cache;
+		uint32 t = (uint32)type;
+
+		while (cache->Budget[t] != 0 && cache->Resident[t] > cache->Budget[t] && cache->LruHead[t] != ContentManagerData::_Cache::None)
+		{
+			uint32 index = cache->LruHead[t];
+			if (unload(index) == false)
+			{
+				// it's not going anywhere, so quit trying
+				lruRemove(index);
+				continue;
+			}
+
+			cache->Evictions++;
+		}
+	}
+
+	bool ContentManager::evictOldest()
+	{
+		auto cache = &m_data->Cache;
+
+		uint32 oldest = ContentManagerData::_Cache::None;
+		for (uint32 i = 0; i < ContentManagerData::_Cache::NumTypes; i++)
+		{
+			uint32 head = cache->LruHead[i];
+			if (head != ContentManagerData::_Cache::None &&
+				(oldest == ContentManagerData::_Cache::None || (int32)(m_data->FileHashTable.Files[head].ReleasedTime - m_data->FileHashTable.Files[oldest].ReleasedTime) < 0))
+				oldest = head;
+		}
+
+		if (oldest == ContentManagerData::_Cache::None)
+			return false;
+
+		if (unload(oldest) == false)
+		{
+			lruRemove(oldest);
+			return evictOldest();
+		}
+
+		cache->Evictions++;
+		return true;
+	}
+
+	// The slot has to be reserved (with its Data allocated) already.
+	void ContentManager::queueLoad(uint32 index, JobPriority priority)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		file->State = LoadState::QueuedForLoad;
+
+		ContentLoadJob job;
+		initLoadJob(&job, m_data->FileHashTable.Filenames[index], file->Type, ContentLoader::FindLoader(file->Type), index);
+
+		if (JobQueue::AddJob(asyncLoadJob, mainThreadLoadJob, &file->Job, &job, sizeof(ContentLoadJob), priority, 0, "content load") == JobQueue::INVALID_JOB)
+		{
+			// the job queue is full, so there's nothing to do but load it now
+			load(m_data->FileHashTable.Filenames[index], file->Type, job.FileLoader, index);
+		}
+	}
+
+	// Gets the file's latest version loaded, without anybody having to wait on it. Loaded files are loaded again
+	// into their own memory (on the job queue), and Tick() swaps the new version in once it's ready, so handles and
+	// pointers to the file keep working. Returns true if a new version is on its way.
+	bool ContentManager::queueReload(uint32 index)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		auto loader = ContentLoader::FindLoader(file->Type);
+
+		uint32 size, alignment;
+		GetResourceInfo(file->Type, &size, &alignment);
+
+		MemoryTagScope tag(getMemoryTag(file->Type));
+
+		switch (file->State)
+		{
+		case LoadState::QueuedForLoad:
+		case LoadState::QueuedForFixup:
+			// it might have read the old version, so it gets loaded again once it's done
+			file->ReloadAgain = true;
+			return true;
+		case LoadState::Error:
+			// maybe it's been fixed. Either way, the handles to it are still good.
+			file->Data = g_memory->AllocTrack(size, __FILE__, __LINE__);
+			queueLoad(index, JobPriority::Background);
+			return true;
+		case LoadState::Loaded:
+			break;
+		default:
+			return false;
+		}
+
+		// nobody's using it, so it can just go (and get loaded again whenever somebody wants it)
+		if (file->InLru)
+		{
+			unload(index);
+			return false;
+		}
+
+		// there's no getting rid of the old version
+		if (loader->UnloaderFunc == nullptr)
+			return false;
+
+		if (file->Reloading)
+		{
+			file->ReloadAgain = true;
+			return true;
+		}
+
+		ContentLoadJob job;
+		initLoadJob(&job, m_data->FileHashTable.Filenames[index], file->Type, loader, index);
+		job.Params.Destination = g_memory->AllocTrack(size, __FILE__, __LINE__);
+		job.Generation = file->Generation;
+		file->Reloading = true;
+
+		// nothing's waiting on it, so it shouldn't get in the way of anything that is
+		if (JobQueue::AddJob(asyncLoadJob, mainThreadReloadJob, nullptr, &job, sizeof(ContentLoadJob), JobPriority::Background, 0, "content reload") == JobQueue::INVALID_JOB)
+		{
+			asyncLoadJob(&job);
+			mainThreadReloadJob(&job);
+		}
+
+		return true;
+	}
+
+	void ContentManager::fileChanged(const char* filename)
+	{
+		uint32 index;
+		if (find(Utils::CalcHash(filename), &index) == false)
+			return;
+
+		// reloading would just read the packed copy again
+		if (FileFinder::IsInArchive(filename))
+		{
+			WriteLog(LogSeverityType::Warning, LogChannelType::Content, "%s changed, but it's loaded from an archive so it isn't being reloaded", filename);
+			return;
+		}
+
+		if (queueReload(index))
+			WriteLog(LogSeverityType::Normal, LogChannelType::Content, "%s changed, reloading it", filename);
+	}
+
+	void ContentManager::initLoadJob(ContentLoadJob* job, StringRef filename, ResourceType type, Loader* loader, uint32 destIndex)
+	{
+		memset(job, 0, sizeof(ContentLoadJob));
+		job->Params.Type = type;
+		job->Params.Destination = m_data->FileHashTable.Files[destIndex].Data;
+		job->Params.FilenameHash = filename;
+		job->Params.LoaderParam = loader->LoaderParam;
+		job->Params.Job = JobQueue::INVALID_JOB;
+		job->FileLoader = loader;
+		job->Index = destIndex;
+		job->Timings.Requested = now();
+		job->Timings.Thread = -1;
+	}
+
+	bool ContentManager::load(StringRef filename, ResourceType type, Loader* loader, uint32 destIndex)
+	{
+		m_data->FileHashTable.Files[destIndex].State = LoadState::QueuedForLoad;
+
+		// the loader only needs its storage until load() returns, so there's no reason for it to come from the heap
+		ContentLoadJob job;
+		initLoadJob(&job, filename, type, loader, destIndex);
+
+		asyncLoadJob(&job);
+		return mainThreadLoadJob(&job);
+	}
+
+	bool ContentManager::asyncLoadJob(void* data)
+	{
+		ContentLoadJob* job = (ContentLoadJob*)data;
+		job->Params.LocalDataStorage = job->LocalDataStorage;
+		job->Params.Phase = LoaderPhase::AsyncLoad;
+		job->Params.Job = JobQueue::GetCurrentJob();
+		job->Timings.AsyncStarted = now();
+		job->Timings.Thread = JobQueue::GetCurrentWorker();
+
+		MemoryTagScope tag(getMemoryTag(job->Params.Type));
+		job->AsyncSucceeded = job->FileLoader->LoaderFunc(&job->Params);
+		job->Timings.AsyncFinished = now();
+
+		// the main thread half has to run either way, since it's the only one allowed to touch the file's state
+		return true;
+	}
+
+	bool ContentManager::mainThreadLoadJob(void* data)
+	{
+		ContentLoadJob* job = (ContentLoadJob*)data;
+		ContentLoaderParams* p = &job->Params;
+		ResourceFile* file = &m_data->FileHashTable.Files[job->Index];
+
+		p->LocalDataStorage = job->LocalDataStorage;
+		job->Timings.MainThreadStarted = now();
+
+		MemoryTagScope tag(getMemoryTag(p->Type));
+
+		if (job->AsyncSucceeded)
+		{
+			p->Phase = LoaderPhase::MainThread;
+			bool succeeded = job->FileLoader->LoaderFunc(p);
+			job->Timings.MainThreadFinished = now();
+
+			if (succeeded)
+			{
+				file->State = LoadState::QueuedForFixup;
+
+				// everything the loader found gets requested at once, so it all loads in parallel
+				for (uint32 i = 0; i < p->NumDependencies; i++)
+					p->Dependencies[i].Handle = addDependency(job->Index, p->Dependencies[i].Filename, p->Dependencies[i].Type);
+
+				if (dependenciesLoading(job->Index, 0) == false)
+					return fixup(job);
+
+				// the job's about to go away, so Tick() (or Wait()) gets its own copy to finish with
+				file->PendingFixup = (ContentLoadJob*)g_memory->AllocTrack(sizeof(ContentLoadJob), __FILE__, __LINE__);
+				memcpy(file->PendingFixup, job, sizeof(ContentLoadJob));
+				m_data->PendingFixups.Indices[m_data->PendingFixups.NumFiles++] = job->Index;
+
+				return true;
+			}
+		}
+
+		recordLoad(job, false, false);
+		loadFailed(job->Index);
+		return false;
+	}
+
+	bool ContentManager::fixup(ContentLoadJob* job)
+	{
+		ContentLoaderParams* p = &job->Params;
+		ResourceFile* file = &m_data->FileHashTable.Files[job->Index];
+
+		p->LocalDataStorage = job->LocalDataStorage;
+		p->Phase = LoaderPhase::Fixup;
+		job->Timings.FixupStarted = now();
+
+		MemoryTagScope tag(getMemoryTag(p->Type));
+
+		bool succeeded = job->FileLoader->LoaderFunc(p);
+		recordLoad(job, succeeded, false);
+
+		if (succeeded == false)
+		{
+			loadFailed(job->Index);
+			return false;
+		}
+
+		uint32 size, alignment;
+		GetResourceInfo(p->Type, &size, &alignment);
+
+		file->State = LoadState::Loaded;
+		file->Size = size + p->ResidentSize;
+		m_data->Cache.Resident[(int)p->Type] += file->Size;
+
+		// whoever wanted it might have changed their mind while it was loading
+		if (file->RefCount == 0)
+			lruAdd(job->Index);
+
+		// the file changed while it was loading, so this might be the old version
+		if (file->ReloadAgain)
+		{
+			file->ReloadAgain = false;
+			queueReload(job->Index);
+		}
+
+		trim(p->Type);
+
+		return true;
+	}
+
+	// anything that was waiting on its dependencies can be finished once they're all done
+	void ContentManager::runReadyFixups()
+	{
+		auto pending = &m_data->PendingFixups;
+		for (uint32 i = 0; i < pending->NumFiles;)
+		{
+			if (dependenciesLoading(pending->Indices[i], 0))
+				i++;
+			else
+				runPendingFixup(pending->Indices[i]);
+		}
+	}
+
+	void ContentManager::runPendingFixup(uint32 index)
+	{
+		auto pending = &m_data->PendingFixups;
+		for (uint32 i = 0; i < pending->NumFiles; i++)
+		{
+			if (pending->Indices[i] == index)
+			{
+				pending->Indices[i] = pending->Indices[--pending->NumFiles];
+				break;
+			}
+		}
+
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		ContentLoadJob* job = file->PendingFixup;
+		file->PendingFixup = nullptr;
+
+		fixup(job);
+		g_memory->FreeTrack(job, __FILE__, __LINE__);
+	}
+
+	void ContentManager::loadFailed(uint32 index)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+
+		// the slot sticks around (so handles to it say what happened), but the memory (and whatever it needed) doesn't
+		g_memory->FreeTrack(file->Data, __FILE__, __LINE__);
+		file->Data = nullptr;
+		file->State = LoadState::Error;
+		releaseDependencies(index);
+
+		// ...unless there aren't any handles to it anymore
+		if (file->RefCount == 0)
+		{
+			m_data->FileHashTable.Active[index] = false;
+			file->State = LoadState::Free;
+		}
+		else if (file->ReloadAgain)
+		{
+			// it might have been half written, so give the newer version a try
+			file->ReloadAgain = false;
+			queueReload(index);
+		}
+	}
+
+	ContentHandle ContentManager::addDependency(uint32 index, StringRef filename, ResourceType type)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+
+		auto handle = Request(filename, type);
+
+		uint32 dependencyIndex;
+		if (getIndex(handle, &dependencyIndex) == false)
+			return INVALID_CONTENT;
+
+		// it already has one reference, which is plenty
+		for (uint32 i = 0; i < file->NumDependencies; i++)
+		{
+			if (file->Dependencies[i] == handle)
+			{
+				Release(handle);
+				return handle;
+			}
+		}
+
+		if (file->NumDependencies == ResourceFile::MaxDependencies)
+		{
+			WriteLog(LogSeverityType::Warning, LogChannelType::Content, "File with hash %u has too many dependencies", m_data->FileHashTable.Hashes[index]);
+			Release(handle);
+			return INVALID_CONTENT;
+		}
+
+		// neither one would ever finish
+		if (dependencyIndex == index || dependsOn(dependencyIndex, index, 0))
+		{
+			WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Ignoring circular dependency between files with hashes %u and %u",
+				m_data->FileHashTable.Hashes[index], m_data->FileHashTable.Hashes[dependencyIndex]);
+			Release(handle);
+			return INVALID_CONTENT;
+		}
+
+		file->Dependencies[file->NumDependencies++] = handle;
+		return handle;
+	}
+
+	// Dependencies can't be circular, so the depth limit is just in case.
+	static const uint32 MaxDependencyDepth = 16;
+
+	bool ContentManager::dependsOn(uint32 index, uint32 dependencyIndex, uint32 depth)
+	{
+		if (depth == MaxDependencyDepth)
+			return true;
+
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		for (uint32 i = 0; i < file->NumDependencies; i++)
+		{
+			uint32 d;
+			if (getIndex(file->Dependencies[i], &d) && (d == dependencyIndex || dependsOn(d, dependencyIndex, depth + 1)))
+				return true;
+		}
+
+		return false;
+	}
+
+	// true if anything the file needs (or anything they need) hasn't finished loading, one way or another
+	bool ContentManager::dependenciesLoading(uint32 index, uint32 depth)
+	{
+		if (depth == MaxDependencyDepth)
+			return false;
+
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+		for (uint32 i = 0; i < file->NumDependencies; i++)
+		{
+			uint32 d;
+			if (getIndex(file->Dependencies[i], &d) == false)
+				continue;
+
+			auto state = m_data->FileHashTable.Files[d].State;
+			if (state == LoadState::QueuedForLoad || state == LoadState::QueuedForFixup || dependenciesLoading(d, depth + 1))
+				return true;
+		}
+
+		return false;
+	}
+
+	void ContentManager::releaseDependencies(uint32 index)
+	{
+		ResourceFile* file = &m_data->FileHashTable.Files[index];
+
+		// releasing them could unload things, so the list gets emptied first
+		ContentHandle dependencies[ResourceFile::MaxDependencies];
+		uint32 numDependencies = file->NumDependencies;
+		memcpy(dependencies, file->Dependencies, sizeof(ContentHandle) * numDependencies);
+		file->NumDependencies = 0;
+
+		for (uint32 i = 0; i < numDependencies; i++)
+			Release(dependencies[i]);
+	}
+
+	bool ContentManager::mainThreadReloadJob(void* data)
+	{
+		ContentLoadJob* job = (ContentLoadJob*)data;
+		ContentLoaderParams* p = &job->Params;
+		ResourceFile* file = &m_data->FileHashTable.Files[job->Index];
+		bool stillLoaded = m_data->FileHashTable.Active[job->Index] && file->Generation == job->Generation;
+
+		p->LocalDataStorage = job->LocalDataStorage;
+		job->Timings.MainThreadStarted = now();
+
+		MemoryTagScope tag(getMemoryTag(p->Type));
+
+		bool succeeded = job->AsyncSucceeded;
+		if (succeeded)
+		{
+			p->Phase = LoaderPhase::MainThread;
+			succeeded = job->FileLoader->LoaderFunc(p);
+			job->Timings.MainThreadFinished = now();
+		}
+		// the file keeps the dependencies it already has (none of the loaders that can unload add any of their own)
+		if (succeeded)
+		{
+			p->Phase = LoaderPhase::Fixup;
+			p->Replacing = stillLoaded ? file->Data : nullptr;
+			job->Timings.FixupStarted = now();
+			succeeded = job->FileLoader->LoaderFunc(p);
+		}
+
+		recordLoad(job, succeeded, true);
+
+		if (succeeded && stillLoaded)
+		{
+			// Tick() swaps it in
+			auto finished = &m_data->Reloads.Finished[m_data->Reloads.NumFinished++];
+			finished->Index = job->Index;
+			finished->Generation = job->Generation;
+			finished->Data = p->Destination;
+			finished->ResidentSize = p->ResidentSize;
+
+			return true;
+		}
+
+		if (succeeded)
+		{
+			// the old version got unloaded while this one was loading, so nobody wants it anymore
+			job->FileLoader->UnloaderFunc(p);
+		}
+		else if (stillLoaded)
+		{
+			WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Unable to reload file with hash %u. Keeping the old version.", m_data->FileHashTable.Hashes[job->Index]);
+			file->Reloading = false;
+
+			// it might have been half written
+			if (file->ReloadAgain)
+			{
+				file->ReloadAgain = false;
+				queueReload(job->Index);
+			}
+		}
+
+		g_memory->FreeTrack(p->Destination, __FILE__, __LINE__);
+		return succeeded;
+	}
+
+	uint64 ContentManager::now()
+	{
+		return m_data->Clock.GetElapsedMicroseconds();
+	}
+
+	static uint32 elapsed(uint64 start, uint64 end)
+	{
+		return start != 0 && end > start ? (uint32)(end - start) : 0;
+	}
+
+	void ContentManager::recordLoad(ContentLoadJob* job, bool succeeded, bool reload)
+	{
+		auto log = &m_data->LoadRecords;
+		ContentLoadRecord* r = &log->Records[log->NextRecord++ % log->MaxRecords];
+		ContentLoadTimings* t = &job->Timings;
+		uint64 finished = now();
+
+		r->Filename = job->Params.FilenameHash;
+		r->Type = job->Params.Type;
+		r->Succeeded = succeeded;
+		r->Reload = reload;
+		r->Thread = t->Thread;
+		r->BytesRead = job->Params.BytesRead;
+
+		r->Queued = elapsed(t->Requested, t->AsyncStarted);
+		r->Read = job->Params.ReadMicroseconds;
+		r->AsyncLoad = elapsed(t->AsyncStarted, t->AsyncFinished);
+		r->WaitingForMainThread = elapsed(t->AsyncFinished, t->MainThreadStarted);
+		r->MainThread = elapsed(t->MainThreadStarted, t->MainThreadFinished);
+		r->WaitingForDependencies = elapsed(t->MainThreadFinished, t->FixupStarted);
+		r->Fixup = elapsed(t->FixupStarted, finished);
+		r->Total = elapsed(t->Requested, finished);
+	}
+}
@@ -14,6 +14,20 @@ namespace Content
 {
 	
 	struct ContentManagerData;
+	struct ContentLoadJob;
+
+	enum class LoadState
+	{
+		Free,
+
+		QueuedForLoad,
+		QueuedForFixup,
+		Loaded,
+		QueuedForUnload,
+		Unloaded,
+
+		Error
+	};
 
 	enum ContentLoadFlags
 	{
@@ -27,30 +41,154 @@ namespace Content
 		ContentLoadFlags_DontPreload = 8,  // don't add the file to the "preload" list.
 	};
 
+	struct ContentCacheStats
+	{
+		static const uint32 NumTypes = (uint32)ResourceType::LAST;
+
+		uint32 Hits;      // Request() or Get() found the file already loaded (or loading)
+		uint32 Misses;    // ...or it had to start loading it
+		uint32 Evictions; // unreferenced files unloaded to stay under budget (or to make room in the table)
+
+		uint64 Resident[NumTypes];
+		uint64 Budget[NumTypes];
+		uint32 NumLoaded[NumTypes];
+		uint32 NumUnreferenced[NumTypes];
+	};
+
+	// Where a load's time went. The times are all in microseconds, and a phase that didn't run is 0.
+	struct ContentLoadRecord
+	{
+		StringRef Filename;
+		ResourceType Type;
+		bool Succeeded;
+		bool Reload;
+		int32 Thread;     // the worker that ran the AsyncLoad phase, or -1 for the main thread
+		uint32 BytesRead; // whatever the loader opened with ContentLoaderParams::OpenAndMap()
+
+		uint32 Queued;    // waiting for a worker
+		uint32 Read;      // the part of AsyncLoad spent opening files
+		uint32 AsyncLoad;
+		uint32 WaitingForMainThread;
+		uint32 MainThread;
+		uint32 WaitingForDependencies;
+		uint32 Fixup;
+		uint32 Total;     // from being requested to being loaded (or failing)
+	};
+
 	class ContentManager
 	{
 		static ContentManagerData* m_data;
 
 	public:
+		static const ContentHandle INVALID_CONTENT = (ContentHandle)-1;
+
 		static void SetGlobalData(ContentManagerData** data, Nxna::Graphics::GraphicsDevice* device);
 		static bool Init(uint32 screenHeight, LocaleCode language, LocaleCode region);
 		static void Shutdown();
 
-		// TODO: implement these
+		// Requests every file in the manifest group (that fits the current resolution and locale) all at once, so
+		// they load in parallel on the job queue. Returns how many files were requested, or -1 if there's no such group.
 		static int PreloadGlobal();
 		static int PreloadScene(uint32 sceneID);
 
+		// Progress of everything that's been preloaded. Returns true while any of it is still loading. Any of the pointers can be null.
+		// Main thread only, since it finishes up files whose dependencies are done.
+		static bool PendingLoads(uint32* numLoaded, uint32* numErrors, uint32* numTotal);
+
+		// Starts loading the file (unless it's already loaded or on its way) and returns right away. The loader's AsyncLoad
+		// phase runs on a job queue worker, and the MainThread and Fixup phases run from JobQueue::Tick().
+		// Takes a reference, which Release() gives back.
+		static ContentHandle Request(StringRef filename, ResourceType type, ContentLoadFlags flags = ContentLoadFlags::ContentLoadFlags_None,
+			JobPriority priority = JobPriority::LoadCritical);
+
+		// LoadState::Free if the handle's no good. It isn't Loaded until everything the file depends on is done
+		// loading too, though anything that failed doesn't hold it up.
+		static LoadState GetState(ContentHandle handle);
+
+		// the content, or null if it isn't loaded (yet)
+		static void* GetData(ContentHandle handle);
+
+		// Only call this from the main thread! Runs JobQueue::Tick() until the content (and everything it depends on)
+		// is done loading.
+		static void* Wait(ContentHandle handle);
+
+		// Requests another file that the content needs (like a model's textures) right away, and the content keeps a
+		// reference to it until it's unloaded. Returns the dependency's handle, which doesn't need to be released.
+		static ContentHandle AddDependency(ContentHandle content, StringRef filename, ResourceType type);
+
+		// Blocks until the content is loaded. Files that nobody has requested yet get loaded right on the calling thread,
+		// but waiting on one that's already loading needs JobQueue::Tick(), so that's only allowed on the main thread.
+		// Files with dependencies have to wait on them too, which is also main thread only.
+		// The reference this takes can't be given back, so the content stays loaded for good. Use Request() and Wait()
+		// for anything that should be allowed to go away.
 		static void* Get(StringRef filename, ResourceType type, ContentLoadFlags flags = ContentLoadFlags::ContentLoadFlags_None);
-		static void Release(void* content);
 
-		static bool ReloadAll();
+		// Main thread, once a frame. Reloads files that have changed (when FileWatcher is watching) and swaps in
+		// whatever's finished reloading.
+		static void Tick();
+
+		// Once nothing references the content it stays cached, but it's first in line to be unloaded (least recently
+		// released first) when its ResourceType goes over its cache budget.
+		static void Release(ContentHandle handle);
+
+		// 0 means no limit, which is the default
+		static void SetCacheBudget(ResourceType type, uint32 bytes);
+		static void GetCacheStats(ContentCacheStats* result);
+
+		// Queues a reload of everything that's loaded (or failed to load) and unloads whatever isn't being used.
+		// Nothing waits on it, the new versions show up at a Tick() once they're ready. Returns how many files are reloading.
+		static uint32 ReloadAll();
+
+		// Copies up to maxRecords of the most recent loads (oldest first) and returns how many there were.
+		// Only the last ContentManagerData::_LoadRecords::MaxRecords are kept.
+		static uint32 GetLoadRecords(ContentLoadRecord* records, uint32 maxRecords);
+
+		// writes the recent loads as JSON if the filename ends with ".json", CSV otherwise
+		static bool WriteLoadRecords(const char* filename);
 		
 		static bool GetResourceInfo(ResourceType type, uint32* size, uint32* alignment);
 
 	private:
 		static ContentLoader* findLoader(LoaderType type);
 
+		static bool loadManifest(const char* filename);
+		static void loadCacheBudgets(const char* filename);
+		static int preload(uint32 groupHash, ContentLoadFlags flags);
+
+		static bool hashFilename(StringRef filename, uint32* hash);
+		static bool find(uint32 hash, uint32* index);
+		static bool reserve(StringRef filename, uint32 hash, ResourceType type, uint32* index);
+		static bool getIndex(ContentHandle handle, uint32* index);
+		static ContentHandle getHandle(uint32 index);
+		static void addRef(uint32 index);
+
+		static void lruAdd(uint32 index);
+		static void lruRemove(uint32 index);
+		static bool unload(uint32 index);
+		static void trim(ResourceType type);
+		static bool evictOldest();
+
+		static ContentHandle addDependency(uint32 index, StringRef filename, ResourceType type);
+		static bool dependsOn(uint32 index, uint32 dependencyIndex, uint32 depth);
+		static bool dependenciesLoading(uint32 index, uint32 depth);
+		static void releaseDependencies(uint32 index);
+
+		static void queueLoad(uint32 index, JobPriority priority);
+		static bool queueReload(uint32 index);
+		static void fileChanged(const char* filename);
+
+		static void initLoadJob(ContentLoadJob* job, StringRef filename, ResourceType type, Loader* loader, uint32 destIndex);
 		static bool load(StringRef hash, ResourceType type, Loader* loader, uint32 destIndex);
+		static bool asyncLoadJob(void* data);
+		static bool mainThreadLoadJob(void* data);
+		static bool fixup(ContentLoadJob* job);
+		static void runReadyFixups();
+		static void runPendingFixup(uint32 index);
+		static void loadFailed(uint32 index);
+		static bool mainThreadReloadJob(void* data);
+
+		static uint64 now();
+		static void recordLoad(ContentLoadJob* job, bool succeeded, bool reload);
 	};
 }
 
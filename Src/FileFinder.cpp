@@ -1,104 +1,326 @@
-#include "FileFinder.h"
-#include "FileSystem.h"
-#include "MemoryManager.h"
-#include "HashStringManager.h"
-
-struct FileFinderData
-{
-	static const uint32 MaxPaths = 10;
-	static const uint32 MaxPathLen = 256;
-	char Paths[MaxPaths][MaxPathLen];
-	uint32 NumPaths;
-};
-
-FileFinderData* FileFinder::m_data;
-
-void FileFinder::SetGlobalData(FileFinderData** data)
-{
-#ifndef FILESYSTEM_BASIC_IMPL
-	if (*data == nullptr)
-	{
-		*data = (FileFinderData*)g_memory->AllocTrack(sizeof(FileFinderData), __FILE__, __LINE__);
-		memset(*data, 0, sizeof(FileFinderData));
-	}
-#endif
-
-	m_data = *data;
-}
-
-void FileFinder::Shutdown()
-{
-#ifndef FILESYSTEM_BASIC_IMPL
-	g_memory->FreeTrack(m_data, __FILE__, __LINE__);
-	m_data = nullptr;
-#endif
-}
-
-void FileFinder::SetSearchPaths(SearchPathInfo* paths, uint32 numPaths)
-{
-	m_data->NumPaths = numPaths;
-
-	for (uint32 i = 0; i < numPaths; i++)
-	{
-		strncpy_s(m_data->Paths[i], paths[i].Path, FileFinderData::MaxPathLen);
-		m_data->Paths[i][FileFinderData::MaxPathLen - 1] = 0;
-
-		//searchPathRecursive(paths[i].Path, "", paths[i].MaxDepth - 1);
-	}
-
-	//LOG("%u files added to search path", m_data->NumFiles);
-}
-
-bool FileFinder::OpenAndMap(StringRef filename, FoundFile* result)
-{
-	auto f = HashStringManager::Get(filename, HashStringManager::HashStringType::File);
-	if (f != nullptr)
-	{
-		return OpenAndMap(f, result);
-	}
-
-	return false;
-}
-
-bool FileFinder::OpenAndMap(const char* filename, FoundFile* result)
-{
-	if (filename == nullptr || result == nullptr)
-		return false;
-
-	char path[512];
-
-	for (uint32 i = 0; i < m_data->MaxPathLen; i++)
-	{
-		path[0] = 0;
-		strncpy_s(path, m_data->Paths[i], 512);
-		strncat_s(path, "/", 512);
-		strncat_s(path, filename, 512);
-
-		if (FileSystem::OpenAndMap(path, &result->F) != nullptr)
-		{
-			result->Memory = result->F.Memory;
-			result->FileSize = result->F.FileSize;
-			result->OwnFile = true;
-			return true;
-		}
-	}
-
-	return false;
-}
-
-void FileFinder::Close(FoundFile* file)
-{
-	if (file != nullptr)
-	{
-		if (file->OwnFile)
-			FileSystem::Close(&file->F);
-
-		file->Memory = nullptr;
-		file->FileSize = 0;
-	}
-}
-
-#define TINYFILES_IMPL
-#include <cerrno>
-//#include "tinyfiles.h"
+#include "FileFinder.h"
+#include "FileSystem.h"
+#include "MemoryManager.h"
+#include "HashStringManager.h"
+#include "Logging.h"
+#include "PackFile.h"
+#include "JobQueue.h"
+#include "lz4block.h"
+#include <stdio.h>
+
+struct FileFinderData
+{
+	static const uint32 MaxPaths = 10;
+	static const uint32 MaxPathLen = 256;
+	char Paths[MaxPaths][MaxPathLen];
+	uint32 NumPaths;
+
+	// these stay mapped until shutdown (even when the game lib gets reloaded)
+	static const uint32 MaxArchives = 4;
+	File Archives[MaxArchives];
+	uint32 NumArchives;
+};
+
+FileFinderData* FileFinder::m_data;
+
+void FileFinder::SetGlobalData(FileFinderData** data)
+{
+#ifndef FILESYSTEM_BASIC_IMPL
+	if (*data == nullptr)
+	{
+		*data = (FileFinderData*)g_memory->AllocAndKeep(sizeof(FileFinderData), __FILE__, __LINE__);
+		memset(*data, 0, sizeof(FileFinderData));
+	}
+#endif
+
+	m_data = *data;
+}
+
+void FileFinder::Shutdown()
+{
+#ifndef FILESYSTEM_BASIC_IMPL
+	for (uint32 i = 0; i < m_data->NumArchives; i++)
+		FileSystem::Close(&m_data->Archives[i]);
+
+	g_memory->FreeTrack(m_data, __FILE__, __LINE__);
+	m_data = nullptr;
+#endif
+}
+
+void FileFinder::SetSearchPaths(SearchPathInfo* paths, uint32 numPaths)
+{
+	if (numPaths > FileFinderData::MaxPaths)
+		numPaths = FileFinderData::MaxPaths;
+
+	m_data->NumPaths = numPaths;
+
+	for (uint32 i = 0; i < numPaths; i++)
+	{
+		snprintf(m_data->Paths[i], FileFinderData::MaxPathLen, "%s", paths[i].Path);
+
+		//searchPathRecursive(paths[i].Path, "", paths[i].MaxDepth - 1);
+	}
+
+	//LOG("%u files added to search path", m_data->NumFiles);
+}
+
+const char* FileFinder::GetSearchPath(uint32 index)
+{
+	if (index >= m_data->NumPaths)
+		return nullptr;
+
+	return m_data->Paths[index];
+}
+
+bool FileFinder::AddArchive(const char* path)
+{
+	if (m_data->NumArchives == FileFinderData::MaxArchives)
+		return false;
+
+	File* archive = &m_data->Archives[m_data->NumArchives];
+	if (FileSystem::OpenAndMap(path, archive) == nullptr)
+		return false;
+
+	// make sure the table of contents can be trusted, so lookups don't have to check anything
+	auto header = (const PackHeader*)archive->Memory;
+	bool valid = archive->FileSize >= sizeof(PackHeader) &&
+		header->FourCC == PackHeader::Magic &&
+		header->Version == PackHeader::CurrentVersion &&
+		header->BlockSize > 0 &&
+		sizeof(PackHeader) + (uint64)header->NumEntries * sizeof(PackEntry) + (uint64)header->NumBlocks * sizeof(PackBlock) + header->NamesSize <= archive->FileSize;
+
+	if (valid)
+	{
+		auto entries = (const PackEntry*)(header + 1);
+		auto blocks = (const PackBlock*)(entries + header->NumEntries);
+		const char* names = (const char*)(blocks + header->NumBlocks);
+
+		for (uint32 i = 0; i < header->NumEntries && valid; i++)
+		{
+			const PackEntry& entry = entries[i];
+			valid = entry.NameOffset < header->NamesSize &&
+				memchr(names + entry.NameOffset, 0, header->NamesSize - entry.NameOffset) != nullptr &&
+				entry.Offset <= archive->FileSize && entry.StoredSize <= archive->FileSize - entry.Offset &&
+				entry.Size <= 0xffffffff &&
+				(i == 0 || entries[i - 1].NameHash <= entry.NameHash);
+
+			if (valid && entry.NumBlocks == 0)
+			{
+				valid = entry.StoredSize == entry.Size;
+			}
+			else if (valid)
+			{
+				valid = entry.NumBlocks == (entry.Size + header->BlockSize - 1) / header->BlockSize &&
+					entry.FirstBlock <= header->NumBlocks && entry.NumBlocks <= header->NumBlocks - entry.FirstBlock;
+
+				for (uint32 j = 0; j < entry.NumBlocks && valid; j++)
+				{
+					const PackBlock& block = blocks[entry.FirstBlock + j];
+					valid = block.CompressedSize <= header->BlockSize &&
+						(uint64)block.Offset + block.CompressedSize <= entry.StoredSize;
+				}
+			}
+		}
+	}
+
+	if (valid == false)
+	{
+		WriteLog(LogSeverityType::Error, LogChannelType::Content, "%s isn't a valid pack file", path);
+		FileSystem::Close(archive);
+		return false;
+	}
+
+	WriteLog(LogSeverityType::Normal, LogChannelType::Content, "Using pack file %s (%u files)", path, header->NumEntries);
+
+	m_data->NumArchives++;
+	return true;
+}
+
+static const PackEntry* findInArchive(const File* archive, const char* filename, uint32 hash)
+{
+	auto header = (const PackHeader*)archive->Memory;
+	auto entries = (const PackEntry*)(header + 1);
+	const char* names = (const char*)((const PackBlock*)(entries + header->NumEntries) + header->NumBlocks);
+
+	// find the first entry with the hash, then check the names of everything that has it
+	uint32 first = 0;
+	uint32 count = header->NumEntries;
+	while (count > 0)
+	{
+		uint32 step = count / 2;
+		if (entries[first + step].NameHash < hash)
+		{
+			first += step + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+
+	for (; first < header->NumEntries && entries[first].NameHash == hash; first++)
+	{
+		if (strcmp(names + entries[first].NameOffset, filename) == 0)
+			return &entries[first];
+	}
+
+	return nullptr;
+}
+
+struct DecompressParams
+{
+	const PackBlock* Blocks;
+	const uint8* Source;
+	uint8* Destination;
+	uint32 BlockSize;
+	uint32 Size;
+	std::atomic<bool> Failed;
+};
+
+static void decompressBlocks(uint32 start, uint32 end, void* param)
+{
+	auto params = (DecompressParams*)param;
+
+	for (uint32 i = start; i < end && params->Failed == false; i++)
+	{
+		const PackBlock& block = params->Blocks[i];
+		uint32 offset = i * params->BlockSize;
+		uint32 size = params->Size - offset < params->BlockSize ? params->Size - offset : params->BlockSize;
+
+		if (block.CompressedSize == size)
+			memcpy(params->Destination + offset, params->Source + block.Offset, size);
+		else if (lz4block_decompress(params->Source + block.Offset, (int)block.CompressedSize, params->Destination + offset, (int)size) != (int)size)
+			params->Failed = true;
+	}
+}
+
+// decompresses straight into the buffer the loader is going to read, one block per chunk so big files use every worker
+static bool decompressEntry(const File* archive, const PackEntry* entry, FoundFile* result)
+{
+	auto header = (const PackHeader*)archive->Memory;
+	auto blocks = (const PackBlock*)((const PackEntry*)(header + 1) + header->NumEntries);
+
+	uint8* memory = (uint8*)g_memory->AllocTrack(entry->Size > 0 ? (size_t)entry->Size : 1, __FILE__, __LINE__);
+
+	DecompressParams params;
+	params.Blocks = blocks + entry->FirstBlock;
+	params.Source = (const uint8*)archive->Memory + entry->Offset;
+	params.Destination = memory;
+	params.BlockSize = header->BlockSize;
+	params.Size = (uint32)entry->Size;
+	params.Failed = false;
+
+	JobQueue::ParallelFor(0, entry->NumBlocks, 1, decompressBlocks, &params);
+
+	if (params.Failed)
+	{
+		g_memory->FreeTrack(memory, __FILE__, __LINE__);
+		return false;
+	}
+
+	result->Memory = memory;
+	result->FileSize = (uint32)entry->Size;
+	result->OwnMemory = true;
+	return true;
+}
+
+bool FileFinder::IsInArchive(const char* filename)
+{
+	if (filename == nullptr || m_data->NumArchives == 0)
+		return false;
+
+	uint32 hash = Utils::CalcHash(filename);
+	for (uint32 i = 0; i < m_data->NumArchives; i++)
+	{
+		auto entry = findInArchive(&m_data->Archives[i], filename, hash);
+		if (entry != nullptr && entry->NumBlocks > 0)
+			return true;
+	}
+
+	return false;
+}
+
+bool FileFinder::OpenAndMap(StringRef filename, FoundFile* result)
+{
+	auto f = HashStringManager::Get(filename, HashStringManager::HashStringType::File);
+	if (f != nullptr)
+	{
+		return OpenAndMap(f, result);
+	}
+
+	return false;
+}
+
+bool FileFinder::OpenAndMap(const char* filename, FoundFile* result)
+{
+	if (filename == nullptr || result == nullptr)
+		return false;
+
+	result->Memory = nullptr;
+	result->FileSize = 0;
+	result->OwnFile = false;
+	result->OwnMemory = false;
+
+	if (m_data->NumArchives > 0)
+	{
+		uint32 hash = Utils::CalcHash(filename);
+		for (uint32 i = 0; i < m_data->NumArchives; i++)
+		{
+			auto entry = findInArchive(&m_data->Archives[i], filename, hash);
+			if (entry != nullptr && entry->NumBlocks > 0)
+			{
+				if (decompressEntry(&m_data->Archives[i], entry, result))
+					return true;
+
+				WriteLog(LogSeverityType::Error, LogChannelType::Content, "Unable to decompress %s", filename);
+				return false;
+			}
+			else if (entry != nullptr)
+			{
+				// it's already mapped, so there's nothing to open (and Close() won't have anything to do either)
+				result->Memory = (uint8*)m_data->Archives[i].Memory + entry->Offset;
+				result->FileSize = (uint32)entry->Size;
+				return true;
+			}
+		}
+	}
+
+	char path[512];
+
+	for (uint32 i = 0; i < m_data->NumPaths; i++)
+	{
+		// a path that doesn't fit can't be the file
+		if (snprintf(path, sizeof(path), "%s/%s", m_data->Paths[i], filename) >= (int)sizeof(path))
+			continue;
+
+		if (FileSystem::OpenAndMap(path, &result->F) != nullptr)
+		{
+			result->Memory = result->F.Memory;
+			result->FileSize = result->F.FileSize;
+			result->OwnFile = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FileFinder::Close(FoundFile* file)
+{
+	if (file != nullptr)
+	{
+		if (file->OwnFile)
+			FileSystem::Close(&file->F);
+		else if (file->OwnMemory)
+			g_memory->FreeTrack(file->Memory, __FILE__, __LINE__);
+
+		file->Memory = nullptr;
+		file->FileSize = 0;
+	}
+}
+
+#define TINYFILES_IMPL
+#include <cerrno>
+//#include "tinyfiles.h"
 #undef TINYFILES_IMPL
\ No newline at end of file
@@ -1,40 +1,49 @@
-#ifndef FILEFINDER_H
-#define FILEFINDER_H
-
-struct FileFinderData;
-
-#include "Common.h"
-#include "FileSystem.h"
-
-struct FoundFile
-{
-	uint32 FileSize;
-	void* Memory;
-
-	File F;
-
-
-	bool OwnFile;
-};
-
-class FileFinder
-{
-	static FileFinderData* m_data;
-
-public:
-	static void SetGlobalData(FileFinderData** data);
-	static void Shutdown();
-
-	struct SearchPathInfo
-	{
-		const char* Path;
-	};
-
-	static void SetSearchPaths(SearchPathInfo* paths, uint32 numPaths);
-
-	static bool OpenAndMap(StringRef filename, FoundFile* result);
-	static bool OpenAndMap(const char* filename, FoundFile* result);
-	static void Close(FoundFile* file);
-};
-
-#endif // FILEFINDER_H
+#ifndef FILEFINDER_H
+#define FILEFINDER_H
+
+struct FileFinderData;
+
+#include "Common.h"
+#include "FileSystem.h"
+
+struct FoundFile
+{
+	uint32 FileSize;
+	void* Memory;
+
+	File F;
+
+
+	bool OwnFile;
+	bool OwnMemory; // it was compressed, so Memory is a buffer it got decompressed into
+};
+
+class FileFinder
+{
+	static FileFinderData* m_data;
+
+public:
+	static void SetGlobalData(FileFinderData** data);
+	static void Shutdown();
+
+	struct SearchPathInfo
+	{
+		const char* Path;
+	};
+
+	static void SetSearchPaths(SearchPathInfo* paths, uint32 numPaths);
+	static const char* GetSearchPath(uint32 index); // null once index is past the last one
+
+	// Maps a pack file (see PackFile.h). Files in archives are found before loose files in
+	// the search paths, and opening or closing them doesn't touch the file system at all.
+	// Compressed files get decompressed into a new buffer by all the job queue workers at once.
+	static bool AddArchive(const char* path);
+	static bool IsInArchive(const char* filename); // true if OpenAndMap() would get it from an archive
+
+
+	static bool OpenAndMap(StringRef filename, FoundFile* result);
+	static bool OpenAndMap(const char* filename, FoundFile* result);
+	static void Close(FoundFile* file);
+};
+
+#endif // FILEFINDER_H
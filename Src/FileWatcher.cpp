@@ -0,0 +1,178 @@
+#include "FileWatcher.h"
+#include "FileFinder.h"
+#include "MemoryManager.h"
+#include "Logging.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <stdio.h>
+#endif
+
+struct FileWatcherData
+{
+	static const uint32 MaxWatches = 256;
+	static const uint32 MaxPathLen = 256;
+
+	// this sticks around even when the game lib gets reloaded
+	bool Watching;
+	int Fd;
+
+	uint32 NumWatches;
+	int Watches[MaxWatches];          // -1 once the directory is gone
+	char Paths[MaxWatches][MaxPathLen]; // the whole path of the directory, ending with a '/'
+	uint32 FilenameStart[MaxWatches]; // where the part after the search path starts
+};
+
+FileWatcherData* FileWatcher::m_data;
+
+#ifdef __linux__
+static void addWatches(FileWatcherData* data, const char* path, uint32 filenameStart)
+{
+	if (data->NumWatches == FileWatcherData::MaxWatches)
+	{
+		WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Too many directories to watch, so changes in %s will be missed", path);
+		return;
+	}
+
+	int wd = inotify_add_watch(data->Fd, path, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+	if (wd == -1)
+		return;
+
+	uint32 index = data->NumWatches++;
+	data->Watches[index] = wd;
+	snprintf(data->Paths[index], FileWatcherData::MaxPathLen, "%s", path);
+	data->FilenameStart[index] = filenameStart;
+
+	DIR* dir = opendir(path);
+	if (dir == nullptr)
+		return;
+
+	dirent* entry;
+	while ((entry = readdir(dir)) != nullptr)
+	{
+		if (entry->d_type != DT_DIR || strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		char subdirectory[FileWatcherData::MaxPathLen];
+		if (snprintf(subdirectory, FileWatcherData::MaxPathLen, "%s%s/", path, entry->d_name) < (int)FileWatcherData::MaxPathLen)
+			addWatches(data, subdirectory, filenameStart);
+	}
+
+	closedir(dir);
+}
+#endif
+
+void FileWatcher::SetGlobalData(FileWatcherData** data)
+{
+	if (*data == nullptr)
+	{
+		*data = (FileWatcherData*)g_memory->AllocAndKeep(sizeof(FileWatcherData), __FILE__, __LINE__);
+		memset(*data, 0, sizeof(FileWatcherData));
+	}
+
+	m_data = *data;
+}
+
+bool FileWatcher::Init()
+{
+	// still going from before the game lib got reloaded
+	if (m_data->Watching)
+		return true;
+
+#ifdef __linux__
+	m_data->Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_data->Fd == -1)
+	{
+		WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Unable to watch for changed files");
+		return false;
+	}
+
+	const char* searchPath;
+	for (uint32 i = 0; (searchPath = FileFinder::GetSearchPath(i)) != nullptr; i++)
+	{
+		// the same way FileFinder builds paths
+		char path[FileWatcherData::MaxPathLen];
+		int length = snprintf(path, FileWatcherData::MaxPathLen, "%s/", searchPath);
+		if (length > 0 && length < (int)FileWatcherData::MaxPathLen)
+			addWatches(m_data, path, (uint32)length);
+	}
+
+	m_data->Watching = true;
+	WriteLog(LogSeverityType::Normal, LogChannelType::Content, "Watching %u directories for changed files", m_data->NumWatches);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void FileWatcher::Shutdown()
+{
+#ifdef __linux__
+	if (m_data->Watching)
+		close(m_data->Fd);
+#endif
+
+	m_data->Watching = false;
+	m_data->NumWatches = 0;
+}
+
+void FileWatcher::Poll(FileChangedCallback callback)
+{
+	if (m_data->Watching == false)
+		return;
+
+#ifdef __linux__
+	alignas(inotify_event) char buffer[4096];
+
+	ssize_t length;
+	while ((length = read(m_data->Fd, buffer, sizeof(buffer))) > 0)
+	{
+		const inotify_event* e;
+		for (char* cursor = buffer; cursor < buffer + length; cursor += sizeof(inotify_event) + e->len)
+		{
+			e = (const inotify_event*)cursor;
+
+			if (e->mask & IN_Q_OVERFLOW)
+			{
+				WriteLog(LogSeverityType::Warning, LogChannelType::Content, "Too many files changed at once, so some of them won't be reloaded");
+				continue;
+			}
+
+			uint32 index = 0;
+			while (index < m_data->NumWatches && m_data->Watches[index] != e->wd)
+				index++;
+
+			if (index == m_data->NumWatches)
+				continue;
+
+			if (e->mask & IN_IGNORED)
+			{
+				// the directory got deleted
+				m_data->Watches[index] = -1;
+				continue;
+			}
+
+			if (e->len == 0)
+				continue;
+
+			// directories get a '/' on the end, just like the ones in Paths
+			bool isDirectory = (e->mask & IN_ISDIR) != 0;
+			char path[FileWatcherData::MaxPathLen];
+			if (snprintf(path, FileWatcherData::MaxPathLen, isDirectory ? "%s%s/" : "%s%s", m_data->Paths[index], e->name) >= (int)FileWatcherData::MaxPathLen)
+				continue;
+
+			if (isDirectory)
+			{
+				if (e->mask & (IN_CREATE | IN_MOVED_TO))
+					addWatches(m_data, path, m_data->FilenameStart[index]);
+			}
+			else if (e->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+			{
+				callback(path + m_data->FilenameStart[index]);
+			}
+		}
+	}
+#endif
+}
@@ -0,0 +1,28 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include "Common.h"
+
+struct FileWatcherData;
+
+// Watches the FileFinder search paths (and every directory under them) for files that get written, so
+// changed content can be reloaded while the game's running. Only Linux (inotify) is supported for now,
+// everywhere else Init() just returns false. Files in pack files aren't watched.
+class FileWatcher
+{
+	static FileWatcherData* m_data;
+
+public:
+	static void SetGlobalData(FileWatcherData** data);
+
+	// watches whatever search paths FileFinder has right now
+	static bool Init();
+	static void Shutdown();
+
+	// Calls the callback for each file that's been written (or moved into place) since the last Poll(). The
+	// filename is relative to its search path, so it's what FileFinder would use to find it. Never blocks.
+	typedef void(*FileChangedCallback)(const char* filename);
+	static void Poll(FileChangedCallback callback);
+};
+
+#endif // FILEWATCHER_H
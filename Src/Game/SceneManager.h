@@ -175,6 +175,9 @@ namespace Game
 
 		static void Process(Nxna::Matrix* modelview, float elapsed);
 		static void Render(Nxna::Matrix* modelview);
+
+	private:
+		static void updateModelAABBs(uint32 start, uint32 end, void* param);
 	};
 }
 
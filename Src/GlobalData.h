@@ -59,6 +59,7 @@ struct JobQueueData;
 struct MemoryManager;
 struct PlatformInfo;
 struct FileFinderData;
+struct FileWatcherData;
 struct VirtualResolutionData;
 struct WaitManagerData;
 
@@ -81,6 +82,10 @@ struct PlatformInfo
 	bool (*CreateCursor)(uint8 width, uint8 height, uint32 hotX, uint32 hotY, uint8* pixels, CursorInfo* result);
 	void (*FreeCursor)(CursorInfo* cursor);
 	void (*SetCursor)(CursorInfo* cursor);
+
+	uint32 NumWorkerThreads; // 0 means one for each core
+	bool PinWorkerThreads;
+	bool AbortOnSteadyStateAllocation; // instead of just counting them
 };
 
 namespace Audio
@@ -96,6 +101,7 @@ struct GlobalData
 	LogData* Log;
 	JobQueueData* JobQueue;
 	FileFinderData* FileSystem;
+	FileWatcherData* FileWatcher;
 	StringManagerData* StringData;
 	HashStringManagerData* HashStringData;
 	VirtualResolutionData* ResolutionData;
@@ -31,6 +31,7 @@ namespace Graphics
 		uint32 NumTextures;
 		static const uint32 MAX_TEXTURES = 10;
 		StringRef Textures[MAX_TEXTURES];
+		Content::ContentHandle TextureHandles[MAX_TEXTURES]; // filled in by BindTextures()
 
 		uint32 VertexStride;
 		uint32 NumVertices;
@@ -48,6 +49,11 @@ namespace Graphics
 
 		static bool LoadObj(Content::ContentLoaderParams* params);
 		static bool FinalizeLoadObj(Content::ContentLoaderParams* params);
+		static bool Unload(Content::ContentLoaderParams* params);
+
+		// Requests everything in Textures[] (without waiting on it) so Render() can get at the textures through their handles.
+		// Call this again whenever Textures[] changes.
+		static void BindTextures(Model* model);
 
 		enum RenderFlags
 		{
@@ -63,7 +63,7 @@ namespace Graphics
 			}
 
 			FoundFile f;
-			if (FileFinder::OpenAndMap(filename, &f) == false)
+			if (params->OpenAndMap(filename, &f) == false)
 			{
 				LOG_ERROR("Unable to open texture %s", filename);
 
@@ -93,6 +93,9 @@ namespace Graphics
 		}
 		else if (params->Phase == Content::LoaderPhase::MainThread)
 		{
+			Bitmap* storage = (Bitmap*)params->LocalDataStorage;
+			params->ResidentSize = storage->Width * storage->Height * 4;
+
 			if (params->Type == Content::ResourceType::Bitmap)
 			{
 				memcpy(params->Destination, params->LocalDataStorage, sizeof(Bitmap));
@@ -101,7 +104,6 @@ namespace Graphics
 			}
 			else
 			{
-				Bitmap* storage = (Bitmap*)params->LocalDataStorage;
 				Nxna::Graphics::Texture2D* destination = (Nxna::Graphics::Texture2D*)params->Destination;
 
 				if (ConvertBitmapToTexture(storage, destination))
@@ -120,6 +122,22 @@ namespace Graphics
 		return true;
 	}
 
+	bool TextureLoader::Unload(Content::ContentLoaderParams* params)
+	{
+		if (params->Type == Content::ResourceType::Bitmap)
+		{
+			Bitmap* bitmap = (Bitmap*)params->Destination;
+			stbi_image_free(bitmap->Pixels);
+			bitmap->Pixels = nullptr;
+		}
+		else
+		{
+			m_data->Device->DestroyTexture2D((Nxna::Graphics::Texture2D*)params->Destination);
+		}
+
+		return true;
+	}
+
 	bool TextureLoader::ConvertBitmapToTexture(Bitmap* bitmap, Nxna::Graphics::Texture2D* result)
 	{
 		Nxna::Graphics::TextureCreationDesc desc = {};
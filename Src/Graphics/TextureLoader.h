@@ -28,6 +28,7 @@ namespace Graphics
 		static Nxna::Graphics::Texture2D GetErrorTexture(bool needOwnership);
 
 		static bool LoadPixels(Content::ContentLoaderParams* params);
+		static bool Unload(Content::ContentLoaderParams* params);
 		static bool ConvertPixelsToTexture(Content::ContentLoaderParams* params);
 		static bool ConvertPixelsToBitmap(Content::ContentLoaderParams* params);
 
@@ -1,4 +1,17 @@
 #include "JobQueue.h"
+#include "Utils.h"
+#include "MemoryManager.h"
+#include "Logging.h"
+#include "ConsoleCommand.h"
+#include "Gui/Console.h"
+#include <cassert>
+#include <cstdio>
+#include <thread>
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 JobQueueData* JobQueue::m_data;
 
@@ -10,12 +23,275 @@ JobQueueData* JobQueue::m_data;
 #define CRITICALSECTION_UNLOCK(lock) pthread_mutex_unlock(lock)
 #endif
 
-void JobQueue::SetGlobalData(JobQueueData** data)
+#if defined _MSC_VER
+#define CPU_RELAX() YieldProcessor()
+#elif defined __i386__ || defined __x86_64__
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX() std::this_thread::yield()
+#endif
+
+static const uint32 InvalidJob = (uint32)-1; // an invalid job index (not handle)
+static const uint32 NoFiber = (uint32)-1;
+
+struct JobThreadState
+{
+	// index of the worker running on this thread, or -1 if this isn't a worker (like the main thread)
+	int32 WorkerIndex;
+
+	// handle of the job this thread is running right now
+	JobHandle CurrentJob;
+
+	// how many jobs in a row this thread has picked while less urgent jobs were waiting
+	uint32 StarvedPicks;
+};
+
+static thread_local JobThreadState t_state = { -1, JobQueue::INVALID_JOB, 0 };
+
+// A job on a fiber can go to sleep on one thread and wake up on another, but the compiler is
+// allowed to hang on to the address of a thread local across a function call. So thread locals
+// are only ever reached through here, and the result mustn't be kept across anything that could
+// run a job.
+#ifdef GAME_ENABLE_JOB_FIBERS
+static __attribute__((noinline)) JobThreadState* getThreadState()
+{
+	asm volatile("" ::: "memory");
+	return &t_state;
+}
+#else
+static JobThreadState* getThreadState()
+{
+	return &t_state;
+}
+#endif
+
+bool JobDeque::Push(uint32 job)
+{
+	int64 b = Bottom.load(std::memory_order_relaxed);
+	int64 t = Top.load(std::memory_order_acquire);
+	if (b - t >= (int64)Capacity)
+		return false;
+
+	Items[b & (Capacity - 1)].store(job, std::memory_order_relaxed);
+	Bottom.store(b + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool JobDeque::Pop(uint32* job)
+{
+	int64 b = Bottom.load(std::memory_order_relaxed) - 1;
+	Bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 t = Top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		// empty
+		Bottom.store(b + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	*job = Items[b & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (t == b)
+	{
+		// this is the last item, so we're racing against the thieves for it
+		bool won = Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		Bottom.store(b + 1, std::memory_order_relaxed);
+		return won;
+	}
+
+	return true;
+}
+
+bool JobDeque::Steal(uint32* job)
+{
+	int64 t = Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 b = Bottom.load(std::memory_order_acquire);
+
+	if (t >= b)
+		return false;
+
+	*job = Items[t & (Capacity - 1)].load(std::memory_order_relaxed);
+	return Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+void JobIndexQueue::Init()
+{
+	for (uint32 i = 0; i < Capacity; i++)
+		Cells[i].Sequence.store(i, std::memory_order_relaxed);
+	EnqueuePosition = 0;
+	DequeuePosition = 0;
+}
+
+bool JobIndexQueue::Enqueue(uint32 job)
+{
+	// this is Dmitry Vyukov's bounded MPMC queue: http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+	uint32 pos = EnqueuePosition.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true)
+	{
+		cell = &Cells[pos & (Capacity - 1)];
+		uint32 seq = cell->Sequence.load(std::memory_order_acquire);
+		int32 diff = (int32)(seq - pos);
+		if (diff == 0)
+		{
+			if (EnqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // full
+		else
+			pos = EnqueuePosition.load(std::memory_order_relaxed);
+	}
+
+	cell->Job = job;
+	cell->Sequence.store(pos + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool JobIndexQueue::Dequeue(uint32* job)
+{
+	uint32 pos = DequeuePosition.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true)
+	{
+		cell = &Cells[pos & (Capacity - 1)];
+		uint32 seq = cell->Sequence.load(std::memory_order_acquire);
+		int32 diff = (int32)(seq - (pos + 1));
+		if (diff == 0)
+		{
+			if (DequeuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // empty
+		else
+			pos = DequeuePosition.load(std::memory_order_relaxed);
+	}
+
+	*job = cell->Job;
+	cell->Sequence.store(pos + Capacity, std::memory_order_release);
+
+	return true;
+}
+
+void JobDeadlineHeap::Init()
+{
+	Lock.clear();
+	Earliest = NoDeadline;
+	Count = 0;
+}
+
+bool JobDeadlineHeap::Push(uint64 deadline, uint32 job)
+{
+	while (Lock.test_and_set(std::memory_order_acquire));
+
+	if (Count >= Capacity)
+	{
+		Lock.clear(std::memory_order_release);
+		return false;
+	}
+
+	uint32 i = Count++;
+	while (i > 0)
+	{
+		uint32 parent = (i - 1) / 2;
+		if (Entries[parent].Deadline <= deadline)
+			break;
+
+		Entries[i] = Entries[parent];
+		i = parent;
+	}
+	Entries[i].Deadline = deadline;
+	Entries[i].Job = job;
+
+	Earliest.store(Entries[0].Deadline, std::memory_order_relaxed);
+	Lock.clear(std::memory_order_release);
+
+	return true;
+}
+
+bool JobDeadlineHeap::Pop(uint32* job)
+{
+	if (Earliest.load(std::memory_order_relaxed) == NoDeadline)
+		return false;
+
+	while (Lock.test_and_set(std::memory_order_acquire));
+
+	if (Count == 0)
+	{
+		Lock.clear(std::memory_order_release);
+		return false;
+	}
+
+	*job = Entries[0].Job;
+
+	Entry last = Entries[--Count];
+	uint32 i = 0;
+	while (true)
+	{
+		uint32 child = i * 2 + 1;
+		if (child >= Count)
+			break;
+		if (child + 1 < Count && Entries[child + 1].Deadline < Entries[child].Deadline)
+			child++;
+		if (last.Deadline <= Entries[child].Deadline)
+			break;
+
+		Entries[i] = Entries[child];
+		i = child;
+	}
+	if (Count > 0)
+		Entries[i] = last;
+
+	Earliest.store(Count > 0 ? Entries[0].Deadline : NoDeadline, std::memory_order_relaxed);
+	Lock.clear(std::memory_order_release);
+
+	return true;
+}
+
+static void cmdJobStats(const char*)
+{
+	WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "Queued jobs: %u frame critical, %u load critical, %u background",
+		JobQueue::GetQueueDepth(JobPriority::FrameCritical),
+		JobQueue::GetQueueDepth(JobPriority::LoadCritical),
+		JobQueue::GetQueueDepth(JobPriority::Background));
+}
+
+#ifdef GAME_ENABLE_JOB_PROFILING
+static void cmdJobHistograms(const char*)
+{
+	JobQueue::LogHistograms();
+}
+
+static void cmdJobTrace(const char* arg)
+{
+	const char* filename = arg && arg[0] ? arg : "jobtrace.json";
+
+	if (JobQueue::WriteTrace(filename))
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "Wrote job trace to %s", filename);
+	else
+		WriteLog(LogSeverityType::Error, LogChannelType::ConsoleOutput, "Unable to write job trace to %s", filename);
+}
+#endif
+
+void JobQueue::SetGlobalData(JobQueueData** data, uint32 numThreads, bool pinThreads)
 {
+	static_assert(JobDeque::Capacity >= JobQueueData::MaxJobs, "Job deques must be able to hold every job");
+	static_assert(JobIndexQueue::Capacity >= JobQueueData::MaxJobs, "Job index queues must be able to hold every job");
+	static_assert(JobQueueData::MaxJobs <= 0xffff, "Job indices must fit in 16 bits");
+
+	uint32 numCores = std::thread::hardware_concurrency();
+	if (numCores == 0)
+		numCores = 1;
+
 	if (*data == nullptr)
 	{
+		// value-initialized, so everything (atomics included) starts out as 0
 		*data = new JobQueueData();
-		memset(*data, 0, sizeof(JobQueueData));
 
 #ifdef _WIN32
 		InitializeCriticalSection(&(*data)->Lock);
@@ -24,65 +300,119 @@ void JobQueue::SetGlobalData(JobQueueData** data)
 		(*data)->Signal = PTHREAD_COND_INITIALIZER;
 		(*data)->Lock = PTHREAD_MUTEX_INITIALIZER;
 #endif
+
+		// leave a core for the main thread
+		if (numThreads == 0)
+			numThreads = numCores > 1 ? numCores - 1 : 1;
+		if (numThreads > JobQueueData::MaxThreads)
+			numThreads = JobQueueData::MaxThreads;
+		(*data)->NumThreads = numThreads;
+		(*data)->PinThreads = pinThreads;
+
+		// spinning only helps if there's a spare core for the job to get added from
+		(*data)->SpinCount = numCores > 1 ? JobQueueData::IdleSpinCount : 0;
+
+		const uint32 numDeques = numThreads * JobQueueData::NumPriorities;
+		(*data)->Deques = (JobDeque*)g_memory->AlignedAllocTrack(sizeof(JobDeque) * numDeques, alignof(JobDeque), __FILE__, __LINE__);
+		for (uint32 i = 0; i < numDeques; i++)
+			new (&(*data)->Deques[i]) JobDeque();
+
+		(*data)->FreeListHead = InvalidJob;
+		for (uint32 i = 0; i < JobQueueData::NumPriorities; i++)
+		{
+			(*data)->Injected[i].Init();
+			(*data)->MainThreadQueue[i].Init();
+			(*data)->Deadlines[i].Init();
+		}
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+		(*data)->FiberLock.clear();
+		(*data)->ReadyFibers.Init();
+		for (uint32 i = 0; i < JobQueueData::MaxThreads; i++)
+		{
+			(*data)->Workers[i].CurrentFiber = NoFiber;
+			(*data)->Workers[i].PendingFree = NoFiber;
+			(*data)->Workers[i].PendingWait = NoFiber;
+		}
+#endif
+
+		(*data)->Clock.Start();
 	}
 
 	m_data = *data;
 	m_data->Active = true;
 
+	if (m_data->NumBlocks == 0)
+		growPool();
+
 	// create the threads
-	for (uint32 i = 0; i < JobQueueData::MaxThreads; i++)
+	for (uint32 i = 0; i < m_data->NumThreads; i++)
 	{
+		// core 0 is left for the main thread
+		uint32 core = (i + 1) % numCores;
+
 #ifdef _WIN32
-		m_data->Threads[i] = CreateThread(nullptr, 0, threadProc, nullptr, 0, nullptr);
+		m_data->Threads[i] = CreateThread(nullptr, 0, threadProc, (void*)(size_t)i, 0, nullptr);
+
+		if (m_data->PinThreads && core < sizeof(DWORD_PTR) * 8)
+			SetThreadAffinityMask(m_data->Threads[i], (DWORD_PTR)1 << core);
 #else
-		if (pthread_create(&m_data->Threads[i], nullptr, threadProc, nullptr) != 0)
+		if (pthread_create(&m_data->Threads[i], nullptr, threadProc, (void*)(size_t)i) != 0)
 		{
 			// TODO: report the error
 		}
+
+#ifdef __linux__
+		if (m_data->PinThreads)
+		{
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			CPU_SET(core, &cpus);
+			pthread_setaffinity_np(m_data->Threads[i], sizeof(cpu_set_t), &cpus);
+		}
+#endif
 #endif
 	}
 }
 
+void JobQueue::Init()
+{
+	ConsoleCommand cmd[] = {
+		{ "job_stats", cmdJobStats },
+#ifdef GAME_ENABLE_JOB_PROFILING
+		{ "job_histograms", cmdJobHistograms },
+		{ "job_trace", cmdJobTrace },
+#endif
+	};
+	Gui::Console::AddCommands(cmd, sizeof(cmd) / sizeof(cmd[0]));
+}
+
 void JobQueue::Shutdown(bool complete)
 {
-	m_data->Active = false;
+	// wait until all jobs are done. The workers have to stay up until then, since jobs that are
+	// finished by the main thread can still add more jobs or wake up jobs that were waiting.
+	while (m_data->NumActiveJobs > 0)
+		Tick();
 
+	CRITICALSECTION_LOCK(&m_data->Lock);
+	m_data->Active = false;
 #ifdef _WIN32
 	WakeAllConditionVariable(&m_data->Signal);
 #else
 	pthread_cond_broadcast(&m_data->Signal);
 #endif
-	// wait until all jobs are done
-	bool waiting = true;
-	while (waiting)
-	{
-		waiting = false;
-
-		for (uint32 i = 0; i < JobQueueData::MaxJobs; i++)
-		{
-			if (m_data->JobStates[i] != JobState::Inactive)
-			{
-				waiting = true;
-
-				if (m_data->JobStates[i] == JobState::WaitingForMainThreadPickup)
-				{
-					m_data->Jobs[i].MainThreadFunc(m_data->Jobs[i].Data);
-					m_data->JobStates[i] = JobState::Inactive;
-				}
-			}
-		}
-	}
+	CRITICALSECTION_UNLOCK(&m_data->Lock);
 
 #ifdef _WIN32
-	WaitForMultipleObjects(JobQueueData::MaxThreads, m_data->Threads, TRUE, INFINITE);
+	WaitForMultipleObjects(m_data->NumThreads, m_data->Threads, TRUE, INFINITE);
 #else
-	for (uint32 i = 0; i < JobQueueData::MaxThreads; i++)
+	for (uint32 i = 0; i < m_data->NumThreads; i++)
 	{
 		pthread_join(m_data->Threads[i], nullptr);
 	}
 #endif
 
-	for (uint32 i = 0; i < JobQueueData::MaxThreads; i++)
+	for (uint32 i = 0; i < m_data->NumThreads; i++)
 	{
 #ifdef _WIN32
 		CloseHandle(m_data->Threads[i]);
@@ -93,212 +423,1354 @@ void JobQueue::Shutdown(bool complete)
 	}
 
 	if (complete)
+	{
+		g_memory->FreeTrack(m_data->Deques, __FILE__, __LINE__);
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+		const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		for (uint32 i = 0; i < m_data->NumFibers; i++)
+		{
+			if (m_data->Fibers[i].Stack)
+				munmap(m_data->Fibers[i].Stack, JobQueueData::FiberStackSize + pageSize);
+		}
+#endif
+
+		for (uint32 i = 0; i < m_data->NumBlocks; i++)
+			g_memory->FreeTrack(m_data->Blocks[i], __FILE__, __LINE__);
+
+		void* page = m_data->Payloads.Pages;
+		while (page)
+		{
+			void* next = *(void**)page;
+			g_memory->FreeTrack(page, __FILE__, __LINE__);
+			page = next;
+		}
+
 		delete m_data;
+	}
 }
 
-uint32 JobQueue::AddJob(JobFunc asyncFunc, JobFunc mainThreadFunc, P_OUT_OPTIONAL JobInfo* result, void* data, size_t dataSize)
+JobHandle JobQueue::AddJob(JobFunc asyncFunc, JobFunc mainThreadFunc, P_OUT_OPTIONAL JobInfo* result, void* data, size_t dataSize, JobPriority priority, uint32 deadlineMicroseconds, const char* name)
 {
-	return AddDependantJob((uint32)-1, asyncFunc, mainThreadFunc, result, data, dataSize);
+	return addJob(INVALID_JOB, priority, deadlineMicroseconds, name, asyncFunc, mainThreadFunc, result, data, dataSize);
 }
 
-uint32 JobQueue::AddDependantJob(uint32 parentJobHandle, JobFunc asyncFunc, JobFunc mainThreadFunc, P_OUT_OPTIONAL JobInfo* result, void* data, size_t dataSize)
+JobHandle JobQueue::AddDependantJob(JobHandle parentJobHandle, JobFunc asyncFunc, JobFunc mainThreadFunc, P_OUT_OPTIONAL JobInfo* result, void* data, size_t dataSize, uint32 deadlineMicroseconds, const char* name)
+{
+	return addJob(parentJobHandle, JobPriority::LoadCritical, deadlineMicroseconds, name, asyncFunc, mainThreadFunc, result, data, dataSize);
+}
+
+JobHandle JobQueue::addJob(JobHandle parentJobHandle, JobPriority priority, uint32 deadlineMicroseconds, const char* name, JobFunc asyncFunc, JobFunc mainThreadFunc, P_OUT_OPTIONAL JobInfo* result, void* data, size_t dataSize)
 {
-	const uint32 invalidJob = (uint32)-1;
-	
 	if (result)
 	{
 		(*result).Result = JobResult::Pending;
-		(*result).Job = invalidJob;
-	}
-	if (dataSize > Job::MaxDataSize)
-	{
-		if (result) (*result).Result = JobResult::Error;
-		return invalidJob;
+		(*result).Job = INVALID_JOB;
 	}
 
-	CRITICALSECTION_LOCK(&m_data->Lock);
-
-	uint32 r = invalidJob;
-	for (uint32 i = 0; i < JobQueueData::MaxJobs; i++)
+	uint32 parentIndex = InvalidJob;
+	if (parentJobHandle != INVALID_JOB)
 	{
-		if (m_data->JobStates[i] == JobState::Inactive)
+		// the parent has to still be around (which it will be if this is being called from the parent's AsyncFunc)
+		parentIndex = JOB_GET_INDEX(parentJobHandle);
+		if (isJobAlive(parentJobHandle) == false)
 		{
-			r = i;
-			if (result) (*result).Job = i;
-			m_data->Jobs[i].Result = result;
-			m_data->Jobs[i].AsyncFunc = asyncFunc;
-			m_data->Jobs[i].MainThreadFunc = mainThreadFunc;
-			memcpy(m_data->Jobs[i].Data, data, dataSize);
-			m_data->DependantJobCount[i] = 0;
-
-			if (parentJobHandle != invalidJob)
-			{
-				m_data->Jobs[i].ParentIndex = parentJobHandle;
-				m_data->DependantJobCount[parentJobHandle]++;
-			}
-			else
-			{
-				m_data->Jobs[i].ParentIndex = (uint32)-1;
-			}
+			if (result) (*result).Result = JobResult::Error;
+			return INVALID_JOB;
+		}
 
-			m_data->JobStates[i] = JobState::WaitingForAsyncPickup;
-			m_data->NumJobs++;
+		// otherwise the parent could end up waiting on work that's less urgent than it is
+		priority = getJob(parentIndex)->Priority;
+		if (name == nullptr)
+			name = getJob(parentIndex)->Name;
+	}
 
-			break;
+	void* payload = nullptr;
+	int32 payloadSizeClass = -1;
+	if (dataSize > Job::MaxDataSize)
+	{
+		payload = allocPayload(dataSize, &payloadSizeClass);
+		if (payload == nullptr)
+		{
+			if (result) (*result).Result = JobResult::Error;
+			return INVALID_JOB;
 		}
 	}
 
-	CRITICALSECTION_UNLOCK(&m_data->Lock);
+	uint32 index = allocJob();
+	if (index == InvalidJob)
+	{
+		if (payload) freePayload(payload, payloadSizeClass);
+		if (result) (*result).Result = JobResult::Error;
+		return INVALID_JOB;
+	}
 
-	if (r != invalidJob)
-#ifdef _WIN32
-		WakeConditionVariable(&m_data->Signal);
-#else
-		pthread_cond_signal(&m_data->Signal);
+	Job* job = getJob(index);
+	job->Result = result;
+	job->AsyncFunc = asyncFunc;
+	job->MainThreadFunc = mainThreadFunc;
+	job->Failed = false;
+	job->Payload = payload ? payload : job->Data;
+	job->PayloadSizeClass = payloadSizeClass;
+	job->Priority = priority;
+	job->Deadline = deadlineMicroseconds > 0 ? m_data->Clock.GetElapsedMicroseconds() + deadlineMicroseconds : 0;
+	job->Name = name;
+#ifdef GAME_ENABLE_JOB_PROFILING
+	memset(&job->Timings, 0, sizeof(JobTimings));
+	job->Timings.Queued = now();
+	job->Timings.Thread = -1;
 #endif
-	else
-		if (result) (*result).Result = JobResult::Error;
+	if (dataSize > 0)
+		memcpy(job->Payload, data, dataSize);
+
+	// the job counts as one of its own dependants until its own work is done
+	job->DependantJobCount = 1;
+
+	job->ParentIndex = parentIndex;
+	if (parentIndex != InvalidJob)
+		getJob(parentIndex)->DependantJobCount++;
 
-	return r;
+	JobHandle handle = ((uint32)job->Checksum << 16) | index;
+	if (result) (*result).Job = handle;
+
+	job->State = JobState::WaitingForAsyncPickup;
+	pushJob(index);
+
+	return handle;
 }
 
-void JobQueue::WaitForJob(volatile JobResult* result)
+void JobQueue::WaitForJob(JobInfo* info)
 {
-	if (result)
+	if (info)
 	{
-		while (*result == JobResult::Pending || *result == JobResult::WaitingOnChildren)
-			Tick();
+		while (info->Result == JobResult::Pending || info->Result == JobResult::WaitingOnChildren)
+		{
+			if (getThreadState()->WorkerIndex < 0)
+			{
+				Tick();
+				continue;
+			}
+
+			// Tick() is only for the main thread, so workers make themselves useful some other way
+			uint32 index;
+			if (findJob(getThreadState()->WorkerIndex, &index))
+				runJob(index);
+			else
+				std::this_thread::yield();
+		}
 	}
 }
 
-void JobQueue::Tick()
+void JobQueue::WaitForJob(JobHandle job)
 {
-	// remember, only call this function from the main thread!
+	if (getThreadState()->WorkerIndex < 0)
+	{
+		while (isJobAlive(job))
+			Tick();
+
+		return;
+	}
 
-	for (uint32 i = 0; i < JobQueueData::MaxJobs; i++)
+#ifdef GAME_ENABLE_JOB_FIBERS
+	JobWorker* worker = &m_data->Workers[getThreadState()->WorkerIndex];
+	if (worker->CurrentFiber != NoFiber && isJobAlive(job))
 	{
-		if (m_data->JobStates[i] == JobState::WaitingForMainThreadPickup)
+		uint32 next = allocFiber();
+		if (next != NoFiber)
 		{
-			m_data->Jobs[i].MainThreadFunc(m_data->Jobs[i].Data);
+			JobHandle currentJob = GetCurrentJob();
 
-			if (m_data->Jobs[i].ParentIndex != (uint32)-1)
-			{
-				m_data->DependantJobCount[m_data->Jobs[i].ParentIndex]--;
+			// the new fiber puts this one on the job's waiting list once we've switched away from it
+			uint32 fiber = worker->CurrentFiber;
+			worker->PendingWait = fiber;
+			worker->PendingWaitJob = job;
+			worker->CurrentFiber = next;
+			swapcontext(&m_data->Fibers[fiber].Context, &m_data->Fibers[next].Context);
 
-				if (m_data->DependantJobCount[m_data->Jobs[i].ParentIndex] == 0 &&
-					m_data->JobStates[m_data->Jobs[i].ParentIndex] == JobState::DoneWaitingOnChildren)
-				{
-					cleanupJob(m_data->Jobs[i].ParentIndex, JobState::Inactive);
-				}
-			}
+			// the job's done and somebody picked this fiber back up, maybe on a different thread
+			afterSwitch();
+			getThreadState()->CurrentJob = currentJob;
 
-			cleanupJob(i, JobState::Inactive);
+			return;
 		}
 	}
-}
+#endif
 
+	// no fiber to switch to, so do other jobs while we wait
+	while (isJobAlive(job))
+	{
+		uint32 index;
+		if (findJob(getThreadState()->WorkerIndex, &index))
+			runJob(index);
+		else
+			std::this_thread::yield();
+	}
+}
 
-#ifdef _WIN32
-DWORD WINAPI JobQueue::threadProc(void* param)
-#else
-void* JobQueue::threadProc(void* param)
-#endif
+void JobQueue::Tick(uint32 budgetMicroseconds)
 {
+	// remember, only call this function from the main thread!
 
-	while (m_data->Active)
+	Utils::Stopwatch timer;
+	timer.Start();
+
+	for (uint32 i = 0; i < JobQueueData::NumPriorities; i++)
 	{
-		CRITICALSECTION_LOCK(&m_data->Lock);
+		// the first job from each class runs no matter what, so a busy frame can't starve less urgent work
+		bool first = true;
 
-		while (m_data->NumJobs == 0 && m_data->Active)
+		uint32 index;
+		while ((first || budgetMicroseconds == 0 || timer.GetElapsedMicroseconds() < budgetMicroseconds) &&
+			m_data->MainThreadQueue[i].Dequeue(&index))
 		{
-#ifdef _WIN32
-			SleepConditionVariableCS(&m_data->Signal, &m_data->Lock, 1000);
-#else
-			pthread_cond_wait(&m_data->Signal, &m_data->Lock);
-#endif
-		}
+			Job* job = getJob(index);
+			job->State = JobState::MainThreadActive;
 
-		const uint32 invalidJob = (uint32)-1;
-		uint32 jobIndex = invalidJob;
-		for (uint32 i = 0; i < JobQueueData::MaxJobs; i++)
-		{
-			if (m_data->JobStates[i] == JobState::WaitingForAsyncPickup)
-			{
-				jobIndex = i;
-				m_data->JobStates[i] = JobState::AsyncActive;
-				m_data->NumJobs--;
-				break;
-			}
-		}
+			JobHandle previousJob = getThreadState()->CurrentJob;
+			getThreadState()->CurrentJob = ((uint32)job->Checksum << 16) | index;
+#ifdef GAME_ENABLE_JOB_PROFILING
+			job->Timings.MainThreadStarted = now();
+#endif
+			bool success = isCancelled(index) || job->MainThreadFunc(job->Payload);
+#ifdef GAME_ENABLE_JOB_PROFILING
+			job->Timings.MainThreadFinished = now();
+#endif
+			getThreadState()->CurrentJob = previousJob;
 
-		CRITICALSECTION_UNLOCK(&m_data->Lock);
+			finishJob(index, success);
 
-		// now we have a job to do
-		if (jobIndex != invalidJob)
-		{
-			if (m_data->Jobs[jobIndex].AsyncFunc(m_data->Jobs[jobIndex].Data))
-			{
-				if (m_data->Jobs[jobIndex].MainThreadFunc != nullptr)
-					m_data->JobStates[jobIndex] = JobState::WaitingForMainThreadPickup;
-				else
-				{
-					if (m_data->Jobs[jobIndex].ParentIndex != (uint32)-1)
-					{
-						CRITICALSECTION_LOCK(&m_data->Lock);
-
-						m_data->DependantJobCount[m_data->Jobs[jobIndex].ParentIndex]--;
-						assert(m_data->DependantJobCount[m_data->Jobs[jobIndex].ParentIndex] >= 0);
-
-						if (m_data->DependantJobCount[m_data->Jobs[jobIndex].ParentIndex] == 0 &&
-							m_data->JobStates[m_data->Jobs[jobIndex].ParentIndex] == JobState::DoneWaitingOnChildren)
-							cleanupJob(m_data->Jobs[jobIndex].ParentIndex, JobState::Inactive);
-
-						CRITICALSECTION_UNLOCK(&m_data->Lock);
-					}
-					
-					if (m_data->DependantJobCount[jobIndex] == 0)
-					{
-						cleanupJob(jobIndex, JobState::Inactive);
-					}
-					else
-					{
-						cleanupJob(jobIndex, JobState::DoneWaitingOnChildren);
-					}
-				}
-			}
-			else
-			{
-				cleanupJob(jobIndex, JobState::Inactive);
-			}
+			first = false;
 		}
 	}
+}
 
-	return 0;
 
-}
+struct ParallelForData
+{
+	ParallelForFunc Func;
+	void* Param;
+	uint32 End;
+	uint32 Grain;
+	std::atomic<uint32> Next;
+	std::atomic<uint32> ChunksRemaining;
+
+	// the caller and every helper job hold a reference, whoever is last frees it
+	std::atomic<uint32> RefCount;
+	int32 SizeClass;
+};
 
-void JobQueue::cleanupJob(uint32 index, JobState state)
+static void runParallelForChunks(ParallelForData* pf)
 {
-	if (m_data->Jobs[index].Result)
+	while (true)
 	{
-		JobResult result;
-		switch (state)
-		{
-		case JobState::DoneWaitingOnChildren:
-			result = JobResult::WaitingOnChildren;
-			break;
-		case JobState::Inactive:
-			result = JobResult::Completed;
+		uint32 start = pf->Next.fetch_add(pf->Grain);
+		if (start >= pf->End)
 			break;
-		default:
-			result = JobResult::Pending;
-			break;
-		}
 
-		(*m_data->Jobs[index].Result).Result = result;
-		(*m_data->Jobs[index].Result).Job = (JobHandle)-1;
-		std::atomic_thread_fence(std::memory_order_release);
+		uint32 end = pf->End - start < pf->Grain ? pf->End : start + pf->Grain;
+		pf->Func(start, end, pf->Param);
+
+		pf->ChunksRemaining--;
+	}
+}
+
+void JobQueue::ParallelFor(uint32 begin, uint32 end, uint32 grain, ParallelForFunc func, void* param)
+{
+	if (end <= begin)
+		return;
+	if (grain == 0)
+		grain = 1;
+
+	uint32 numChunks = (end - begin - 1) / grain + 1;
+	if (numChunks == 1)
+	{
+		func(begin, end, param);
+		return;
+	}
+
+	// the helper jobs might not get picked up until after this returns, so the shared data can't live on the stack
+	int32 sizeClass;
+	ParallelForData* pf = (ParallelForData*)allocPayload(sizeof(ParallelForData), &sizeClass);
+	if (pf == nullptr)
+	{
+		func(begin, end, param);
+		return;
 	}
 
-	m_data->JobStates[index] = state;
+	uint32 numHelpers = numChunks - 1 < m_data->NumThreads ? numChunks - 1 : m_data->NumThreads;
+
+	pf->Func = func;
+	pf->Param = param;
+	pf->End = end;
+	pf->Grain = grain;
+	pf->Next = begin;
+	pf->ChunksRemaining = numChunks;
+	pf->RefCount = numHelpers + 1;
+	pf->SizeClass = sizeClass;
+
+	// The caller is stuck until every chunk is done, so the helpers are as urgent as the caller is. That's the
+	// job it's running (so a background load doesn't crowd out frame work), or FrameCritical for the main thread.
+	JobPriority priority = JobPriority::FrameCritical;
+	JobHandle currentJob = GetCurrentJob();
+	if (currentJob != INVALID_JOB && isJobAlive(currentJob))
+		priority = getJob(JOB_GET_INDEX(currentJob))->Priority;
+
+	for (uint32 i = 0; i < numHelpers; i++)
+	{
+		if (AddJob(parallelForJob, nullptr, nullptr, &pf, sizeof(pf), priority, 0, "ParallelFor") == INVALID_JOB)
+			pf->RefCount--;
+	}
+
+	runParallelForChunks(pf);
+
+	// wait for any chunks that other threads are still working on
+	while (pf->ChunksRemaining > 0)
+		std::this_thread::yield();
+
+	if (pf->RefCount.fetch_sub(1) == 1)
+		freePayload(pf, sizeClass);
+}
+
+bool JobQueue::parallelForJob(void* data)
+{
+	ParallelForData* pf = *(ParallelForData**)data;
+
+	runParallelForChunks(pf);
+
+	if (pf->RefCount.fetch_sub(1) == 1)
+		freePayload(pf, pf->SizeClass);
+
+	return true;
+}
+
+JobHandle JobQueue::GetCurrentJob()
+{
+	return getThreadState()->CurrentJob;
+}
+
+int32 JobQueue::GetCurrentWorker()
+{
+	return getThreadState()->WorkerIndex;
+}
+
+uint32 JobQueue::GetQueueDepth(JobPriority priority)
+{
+	return m_data->QueueDepth[(uint32)priority];
+}
+
+
+#ifdef _WIN32
+DWORD WINAPI JobQueue::threadProc(void* param)
+#else
+void* JobQueue::threadProc(void* param)
+#endif
+{
+	getThreadState()->WorkerIndex = (int32)(size_t)param;
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+	// run the worker on a fiber, so the thread's own stack is free to go back to when it's time to exit
+	JobWorker* worker = &m_data->Workers[(size_t)param];
+	uint32 fiber = allocFiber();
+	if (fiber != NoFiber)
+	{
+		worker->CurrentFiber = fiber;
+		swapcontext(&worker->Context, &m_data->Fibers[fiber].Context);
+
+		// the worker loop's done and we're back on the thread's own stack
+		afterSwitch();
+
+		return 0;
+	}
+#endif
+
+	workerLoop();
+
+	return 0;
+}
+
+void JobQueue::workerLoop()
+{
+	while (true)
+	{
+#ifdef GAME_ENABLE_JOB_FIBERS
+		// jobs that are done waiting go first, since they've already started
+		JobWorker* worker = &m_data->Workers[getThreadState()->WorkerIndex];
+		uint32 fiber;
+		if (worker->CurrentFiber != NoFiber && m_data->ReadyFibers.Dequeue(&fiber))
+		{
+			m_data->NumJobs--;
+
+			// there's nothing on this fiber worth coming back to, so it gets freed once we're off it
+			worker->PendingFree = worker->CurrentFiber;
+			worker->CurrentFiber = fiber;
+			setcontext(&m_data->Fibers[fiber].Context);
+		}
+#endif
+
+		uint32 jobIndex;
+		if (findJob(getThreadState()->WorkerIndex, &jobIndex))
+		{
+			runJob(jobIndex);
+			continue;
+		}
+
+		// keep going until the queues are empty, even after shutdown has started
+		if (m_data->Active == false)
+			break;
+
+		// nothing to do, but new work usually shows up soon (like the next stage of a frame), so
+		// spin for a bit before paying for a sleep and wake up
+		for (uint32 i = 0; i < m_data->SpinCount && m_data->NumJobs == 0 && m_data->Active; i++)
+			CPU_RELAX();
+
+		if (m_data->NumJobs > 0)
+			continue;
+
+		// still nothing to do, so go to sleep until somebody adds a job
+		CRITICALSECTION_LOCK(&m_data->Lock);
+		m_data->NumSleepingThreads++;
+
+		while (m_data->NumJobs == 0 && m_data->Active)
+		{
+#ifdef _WIN32
+			SleepConditionVariableCS(&m_data->Signal, &m_data->Lock, 1000);
+#else
+			pthread_cond_wait(&m_data->Signal, &m_data->Lock);
+#endif
+		}
+
+		m_data->NumSleepingThreads--;
+		CRITICALSECTION_UNLOCK(&m_data->Lock);
+	}
+}
+
+uint32 JobQueue::allocJob()
+{
+	while (true)
+	{
+		uint64 head = m_data->FreeListHead.load(std::memory_order_acquire);
+		while ((uint32)head != InvalidJob)
+		{
+			uint32 index = (uint32)head;
+			uint32 next = getJob(index)->NextFree.load(std::memory_order_relaxed);
+			uint64 newHead = (((head >> 32) + 1) << 32) | next;
+			if (m_data->FreeListHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				// Make the checksum odd, which means it's alive. An even CancelledChecksum can't match it, so a job
+				// that was cancelled in this slot 32768 uses ago (when the checksum wraps) can't cancel this one.
+				Job* job = getJob(index);
+				job->CancelledChecksum = 0;
+				job->Checksum++;
+#ifdef GAME_ENABLE_JOB_FIBERS
+				job->Waiters = ((uint64)job->Checksum << 32) | NoFiber;
+#endif
+				m_data->NumActiveJobs++;
+				return index;
+			}
+		}
+
+		// out of free slots, so try adding another block
+		if (growPool() == false)
+			return InvalidJob;
+	}
+}
+
+void JobQueue::freeJob(uint32 index)
+{
+	Job* job = getJob(index);
+	if (job->PayloadSizeClass >= 0)
+		freePayload(job->Payload, job->PayloadSizeClass);
+
+	uint64 head = m_data->FreeListHead.load(std::memory_order_relaxed);
+	uint64 newHead;
+	do
+	{
+		job->NextFree.store((uint32)head, std::memory_order_relaxed);
+		newHead = (((head >> 32) + 1) << 32) | index;
+	} while (m_data->FreeListHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed) == false);
+
+	m_data->NumActiveJobs--;
+}
+
+bool JobQueue::growPool()
+{
+	bool result = true;
+
+	CRITICALSECTION_LOCK(&m_data->Lock);
+
+	// somebody else may have already added a block while we were waiting for the lock
+	if ((uint32)m_data->FreeListHead.load(std::memory_order_acquire) == InvalidJob)
+	{
+		uint32 blockIndex = m_data->NumBlocks;
+		if (blockIndex >= JobQueueData::MaxJobBlocks)
+		{
+			result = false;
+		}
+		else
+		{
+			JobBlock* block = NewObject<JobBlock>(__FILE__, __LINE__);
+
+			uint32 first = blockIndex * JobBlock::Size;
+			for (uint32 i = 0; i < JobBlock::Size; i++)
+				block->Jobs[i].NextFree = first + i + 1;
+
+			m_data->Blocks[blockIndex] = block;
+			m_data->NumBlocks = blockIndex + 1;
+
+			// put the whole block on the free list at once
+			uint64 head = m_data->FreeListHead.load(std::memory_order_relaxed);
+			uint64 newHead;
+			do
+			{
+				block->Jobs[JobBlock::Size - 1].NextFree.store((uint32)head, std::memory_order_relaxed);
+				newHead = (((head >> 32) + 1) << 32) | first;
+			} while (m_data->FreeListHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed) == false);
+		}
+	}
+
+	CRITICALSECTION_UNLOCK(&m_data->Lock);
+
+	return result;
+}
+
+void* JobQueue::allocPayload(size_t size, int32* sizeClass)
+{
+	if (size > JobPayloadPool::MaxSize)
+		return nullptr;
+
+	int32 c = 0;
+	while ((JobPayloadPool::MinSize << c) < size)
+		c++;
+	*sizeClass = c;
+
+	JobPayloadPool* pool = &m_data->Payloads;
+
+	while (pool->Locks[c].test_and_set(std::memory_order_acquire));
+	void* buffer = pool->FreeLists[c];
+	if (buffer)
+		pool->FreeLists[c] = *(void**)buffer;
+	pool->Locks[c].clear(std::memory_order_release);
+
+	if (buffer)
+		return buffer;
+
+	// the free list is empty, so carve up a new page. The first 16 bytes are for the page list.
+	const uint32 bufferSize = JobPayloadPool::MinSize << c;
+	const uint32 numBuffers = bufferSize < JobPayloadPool::PageSize ? JobPayloadPool::PageSize / bufferSize : 1;
+	uint8* page = (uint8*)g_memory->AllocTrack(16 + bufferSize * numBuffers, __FILE__, __LINE__);
+	if (page == nullptr)
+		return nullptr;
+
+	while (pool->PageLock.test_and_set(std::memory_order_acquire));
+	*(void**)page = pool->Pages;
+	pool->Pages = page;
+	pool->PageLock.clear(std::memory_order_release);
+
+	// keep the first buffer and put the rest on the free list
+	buffer = page + 16;
+	if (numBuffers > 1)
+	{
+		for (uint32 i = 1; i < numBuffers - 1; i++)
+			*(void**)(page + 16 + bufferSize * i) = page + 16 + bufferSize * (i + 1);
+
+		while (pool->Locks[c].test_and_set(std::memory_order_acquire));
+		*(void**)(page + 16 + bufferSize * (numBuffers - 1)) = pool->FreeLists[c];
+		pool->FreeLists[c] = page + 16 + bufferSize;
+		pool->Locks[c].clear(std::memory_order_release);
+	}
+
+	return buffer;
+}
+
+void JobQueue::freePayload(void* payload, int32 sizeClass)
+{
+	JobPayloadPool* pool = &m_data->Payloads;
+
+	while (pool->Locks[sizeClass].test_and_set(std::memory_order_acquire));
+	*(void**)payload = pool->FreeLists[sizeClass];
+	pool->FreeLists[sizeClass] = payload;
+	pool->Locks[sizeClass].clear(std::memory_order_release);
+}
+
+void JobQueue::pushJob(uint32 index)
+{
+	Job* job = getJob(index);
+	uint32 priority = (uint32)job->Priority;
+	m_data->QueueDepth[priority]++;
+
+	// jobs with deadlines get sorted, as long as there's room. Otherwise workers put new jobs
+	// on their own deque and everybody else uses the shared injection queue.
+	bool queued = job->Deadline != 0 && m_data->Deadlines[priority].Push(job->Deadline, index);
+	if (queued == false)
+	{
+		int32 workerIndex = getThreadState()->WorkerIndex;
+		if (workerIndex >= 0)
+			queued = m_data->Deques[workerIndex * JobQueueData::NumPriorities + priority].Push(index);
+		else
+		{
+			// the injection queue can look full when it isn't, if a thread that's dequeuing got preempted
+			// between claiming its cell and releasing it. That clears up as soon as that thread runs again.
+			while ((queued = m_data->Injected[priority].Enqueue(index)) == false)
+				std::this_thread::yield();
+		}
+	}
+
+	assert(queued && "Job queues should always have room for every job");
+	(void)queued;
+
+	m_data->NumJobs++;
+	wakeWorker();
+}
+
+void JobQueue::wakeWorker()
+{
+	// only bother with the lock if somebody is actually asleep. Taking the lock makes sure a
+	// worker that's about to sleep either sees NumJobs or is already waiting. Signalling after
+	// the unlock keeps the woken worker from immediately blocking on the lock again.
+	if (m_data->NumSleepingThreads > 0)
+	{
+		CRITICALSECTION_LOCK(&m_data->Lock);
+		CRITICALSECTION_UNLOCK(&m_data->Lock);
+#ifdef _WIN32
+		WakeConditionVariable(&m_data->Signal);
+#else
+		pthread_cond_signal(&m_data->Signal);
+#endif
+	}
+}
+
+bool JobQueue::findJob(int32 workerIndex, uint32* index)
+{
+	uint32 priority = 0;
+	bool lowestFirst = false;
+
+	// anything that's missed its deadline goes first, no matter what class it's in
+	uint64 earliest = JobDeadlineHeap::NoDeadline;
+	for (uint32 i = 0; i < JobQueueData::NumPriorities; i++)
+	{
+		uint64 deadline = m_data->Deadlines[i].Earliest.load(std::memory_order_relaxed);
+		if (deadline < earliest)
+		{
+			earliest = deadline;
+			priority = i;
+		}
+	}
+	if (earliest != JobDeadlineHeap::NoDeadline && earliest <= m_data->Clock.GetElapsedMicroseconds() &&
+		m_data->Deadlines[priority].Pop(index))
+		goto found;
+
+	// after passing over less urgent work too many times, look at it first for once
+	lowestFirst = getThreadState()->StarvedPicks >= JobQueueData::MaxStarvedPicks;
+	for (uint32 i = 0; i < JobQueueData::NumPriorities; i++)
+	{
+		priority = lowestFirst ? JobQueueData::NumPriorities - 1 - i : i;
+		if (m_data->QueueDepth[priority] > 0 && findJob(workerIndex, priority, index))
+			goto found;
+	}
+
+	return false;
+
+found:
+	m_data->NumJobs--;
+	m_data->QueueDepth[priority]--;
+
+	if (lowestFirst)
+	{
+		getThreadState()->StarvedPicks = 0;
+	}
+	else
+	{
+		bool starving = false;
+		for (uint32 i = priority + 1; i < JobQueueData::NumPriorities; i++)
+			starving = starving || m_data->QueueDepth[i] > 0;
+
+		JobThreadState* state = getThreadState();
+		state->StarvedPicks = starving ? state->StarvedPicks + 1 : 0;
+	}
+
+	return true;
+}
+
+bool JobQueue::findJob(int32 workerIndex, uint32 priority, uint32* index)
+{
+	const uint32 n = JobQueueData::NumPriorities;
+
+	// jobs with deadlines first, earliest first
+	if (m_data->Deadlines[priority].Pop(index))
+		return true;
+
+	// then our own work (newest first, since it's most likely to still be in the cache)
+	if (workerIndex >= 0 && m_data->Deques[workerIndex * n + priority].Pop(index))
+		return true;
+
+	if (m_data->Injected[priority].Dequeue(index))
+		return true;
+
+	// steal from everybody else, oldest first
+	for (uint32 i = 1; i <= m_data->NumThreads; i++)
+	{
+		uint32 victim = (uint32)(workerIndex + i) % m_data->NumThreads;
+		if ((int32)victim != workerIndex && m_data->Deques[victim * n + priority].Steal(index))
+			return true;
+	}
+
+	return false;
+}
+
+void JobQueue::runJob(uint32 index)
+{
+	Job* job = getJob(index);
+
+	// cancelled before it got a chance to start, so don't bother
+	if (isCancelled(index))
+	{
+		finishJob(index, true);
+		return;
+	}
+
+	job->State = JobState::AsyncActive;
+
+#ifdef GAME_ENABLE_JOB_PROFILING
+	job->Timings.AsyncStarted = now();
+	job->Timings.Thread = getThreadState()->WorkerIndex;
+#endif
+
+	JobHandle previousJob = getThreadState()->CurrentJob;
+	getThreadState()->CurrentJob = ((uint32)job->Checksum << 16) | index;
+	bool success = job->AsyncFunc == nullptr || job->AsyncFunc(job->Payload);
+	getThreadState()->CurrentJob = previousJob;
+
+#ifdef GAME_ENABLE_JOB_PROFILING
+	job->Timings.AsyncFinished = now();
+#endif
+
+	if (success && job->MainThreadFunc != nullptr)
+	{
+		job->State = JobState::WaitingForMainThreadPickup;
+
+		bool queued = m_data->MainThreadQueue[(uint32)job->Priority].Enqueue(index);
+		assert(queued && "Main thread queue should always have room for every job");
+		(void)queued;
+
+		return;
+	}
+
+	finishJob(index, success);
+}
+
+void JobQueue::finishJob(uint32 index, bool success)
+{
+	// the job's own work is done, but it may still have children that aren't
+
+#ifdef GAME_ENABLE_JOB_PROFILING
+	recordJob(index);
+#endif
+
+	if (success == false)
+		getJob(index)->Failed = true;
+
+	if (getJob(index)->DependantJobCount > 1)
+		cleanupJob(index, JobState::DoneWaitingOnChildren, JobResult::WaitingOnChildren);
+
+	// whoever drops the count to 0 (this job or its last child) gets to finish it off
+	while (index != InvalidJob && getJob(index)->DependantJobCount.fetch_sub(1) == 1)
+	{
+		Job* job = getJob(index);
+		uint32 parent = job->ParentIndex;
+		if (job->Failed && parent != InvalidJob)
+			getJob(parent)->Failed = true;
+
+		// this has to be checked while the checksum's still good
+		JobResult result = isCancelled(index) ? JobResult::Cancelled :
+			job->Failed ? JobResult::Error : JobResult::Completed;
+
+		// make the checksum even before anybody can see the result, so old handles to this slot stop working
+		job->Checksum++;
+
+		cleanupJob(index, JobState::Inactive, result);
+#ifdef GAME_ENABLE_JOB_FIBERS
+		wakeWaiters(index);
+#endif
+		freeJob(index);
+
+		index = parent;
+	}
+}
+
+void JobQueue::cleanupJob(uint32 index, JobState state, JobResult result)
+{
+	Job* job = getJob(index);
+	if (job->Result)
+	{
+		// the JobInfo's owner is free to throw it away as soon as the result shows up, so it goes last
+		if (state == JobState::Inactive)
+			job->Result->Job.store(INVALID_JOB, std::memory_order_relaxed);
+		job->Result->Result.store(result, std::memory_order_release);
+	}
+
+	job->State = state;
+}
+
+bool JobQueue::isJobAlive(JobHandle job)
+{
+	uint32 index = JOB_GET_INDEX(job);
+
+	return job != INVALID_JOB &&
+		index < m_data->NumBlocks * JobBlock::Size &&
+		getJob(index)->Checksum == (job >> 16);
+}
+
+bool JobQueue::isCancelled(uint32 index)
+{
+	// a job's parents can't finish before it does, so they're all still around
+	while (index != InvalidJob)
+	{
+		Job* job = getJob(index);
+		if (job->CancelledChecksum == job->Checksum)
+			return true;
+
+		index = job->ParentIndex;
+	}
+
+	return false;
+}
+
+bool JobQueue::Cancel(JobHandle job)
+{
+	if (isJobAlive(job) == false)
+		return false;
+
+	uint16 checksum = (uint16)(job >> 16);
+	Job* j = getJob(JOB_GET_INDEX(job));
+
+	// If the slot gets reused while we're in here the CAS makes sure we can't undo a cancel of the
+	// new job. Writing the old checksum is harmless since it won't match the new job's.
+	uint16 cancelled = j->CancelledChecksum;
+	while (cancelled != checksum)
+	{
+		if (isJobAlive(job) == false)
+			return false;
+
+		if (j->CancelledChecksum.compare_exchange_weak(cancelled, checksum))
+			break;
+	}
+
+	return isJobAlive(job);
+}
+
+bool JobQueue::IsCancelled()
+{
+	JobHandle job = GetCurrentJob();
+	if (job == INVALID_JOB)
+		return false;
+
+	return isCancelled(JOB_GET_INDEX(job));
+}
+
+JobStatus JobQueue::GetStatus(JobHandle job)
+{
+	if (isJobAlive(job) == false)
+		return JobStatus::Done;
+
+	JobState state = getJob(JOB_GET_INDEX(job))->State;
+
+	// make sure the slot didn't get reused while we were looking at it
+	if (isJobAlive(job) == false)
+		return JobStatus::Done;
+
+	switch (state)
+	{
+	case JobState::WaitingForAsyncPickup:
+		return JobStatus::Queued;
+	case JobState::AsyncActive:
+	case JobState::MainThreadActive:
+		return JobStatus::Running;
+	case JobState::WaitingForMainThreadPickup:
+		return JobStatus::WaitingForMainThread;
+	case JobState::DoneWaitingOnChildren:
+		return JobStatus::WaitingOnChildren;
+	default:
+		return JobStatus::Done;
+	}
+}
+
+#ifdef GAME_ENABLE_JOB_PROFILING
+void JobQueue::recordJob(uint32 index)
+{
+	Job* job = getJob(index);
+	JobProfile* profile = &m_data->Profile;
+
+	uint32 n = profile->NextEvent.fetch_add(1, std::memory_order_relaxed);
+	JobProfileEvent* e = &profile->Events[n % JobProfile::MaxEvents];
+
+	// the sequence is odd while the record is being written, so anybody copying it knows to skip it
+	e->Sequence.store(n * 2 + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	e->Record.Name = job->Name;
+	e->Record.Priority = job->Priority;
+	e->Record.Timings = job->Timings;
+
+	e->Sequence.store(n * 2 + 2, std::memory_order_release);
+}
+
+uint32 JobQueue::copyRecords(JobRecord* records)
+{
+	JobProfile* profile = &m_data->Profile;
+
+	uint32 end = profile->NextEvent.load(std::memory_order_acquire);
+	uint32 count = end < JobProfile::MaxEvents ? end : JobProfile::MaxEvents;
+
+	uint32 numRecords = 0;
+	for (uint32 i = end - count; i != end; i++)
+	{
+		JobProfileEvent* e = &profile->Events[i % JobProfile::MaxEvents];
+
+		uint32 sequence = e->Sequence.load(std::memory_order_acquire);
+		if (sequence == 0 || (sequence & 1) != 0)
+			continue;
+
+		records[numRecords] = e->Record;
+
+		// skip it if it got overwritten while we were copying it
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (e->Sequence.load(std::memory_order_relaxed) == sequence)
+			numRecords++;
+	}
+
+	return numRecords;
+}
+
+struct JobHistogram
+{
+	// bucket i is for times under 2^i microseconds (the last one is for everything else)
+	static const uint32 NumBuckets = 24;
+	uint32 Counts[NumBuckets];
+	uint32 Total;
+	uint64 Max;
+
+	void Add(uint64 microseconds)
+	{
+		uint32 bucket = 0;
+		while (bucket < NumBuckets - 1 && ((uint64)1 << bucket) <= microseconds)
+			bucket++;
+
+		Counts[bucket]++;
+		Total++;
+		if (microseconds > Max)
+			Max = microseconds;
+	}
+
+	uint64 Percentile(uint32 percent)
+	{
+		uint32 count = 0;
+		for (uint32 i = 0; i < NumBuckets; i++)
+		{
+			count += Counts[i];
+			if (count * 100 >= Total * percent)
+				return (uint64)1 << i;
+		}
+
+		return Max;
+	}
+
+	void Log(const char* name)
+	{
+		if (Total == 0)
+		{
+			WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%s: no jobs", name);
+			return;
+		}
+
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%s: %u jobs, 50%% under %lluus, 90%% under %lluus, 99%% under %lluus, max %lluus", name, Total,
+			(unsigned long long)Percentile(50), (unsigned long long)Percentile(90), (unsigned long long)Percentile(99), (unsigned long long)Max);
+
+		char buffer[512];
+		uint32 length = 0;
+		for (uint32 i = 0; i < NumBuckets && length < sizeof(buffer); i++)
+		{
+			if (Counts[i] > 0)
+				length += snprintf(buffer + length, sizeof(buffer) - length, " <%lluus:%u", (unsigned long long)1 << i, Counts[i]);
+		}
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "  %s", buffer);
+	}
+};
+
+void JobQueue::LogHistograms()
+{
+	JobRecord* records = (JobRecord*)g_memory->AllocTrack(sizeof(JobRecord) * JobProfile::MaxEvents, __FILE__, __LINE__);
+	uint32 numRecords = copyRecords(records);
+
+	JobHistogram queued = {}, async = {}, waiting = {}, mainThread = {};
+	for (uint32 i = 0; i < numRecords; i++)
+	{
+		JobTimings* t = &records[i].Timings;
+		if (t->AsyncStarted > 0)
+		{
+			queued.Add(t->AsyncStarted - t->Queued);
+			async.Add(t->AsyncFinished - t->AsyncStarted);
+		}
+		if (t->MainThreadStarted > 0)
+		{
+			waiting.Add(t->MainThreadStarted - t->AsyncFinished);
+			mainThread.Add(t->MainThreadFinished - t->MainThreadStarted);
+		}
+	}
+
+	queued.Log("Waiting for a worker");
+	async.Log("Running");
+	waiting.Log("Waiting for the main thread");
+	mainThread.Log("Running on the main thread");
+
+	g_memory->FreeTrack(records, __FILE__, __LINE__);
+}
+
+// Windows puts \ in paths, which aren't legal in json without escaping them, so they're replaced with /
+static void escapeJson(char* destination, uint32 destLength, const char* text)
+{
+	uint32 length = 0;
+	for (const char* c = text; *c != 0 && length + 2 < destLength; c++)
+	{
+		if (*c == '"')
+			destination[length++] = '\\';
+
+		if (*c == '\\')
+			destination[length++] = '/';
+		else if ((unsigned char)*c >= ' ')
+			destination[length++] = *c;
+	}
+	destination[length] = 0;
+}
+
+bool JobQueue::WriteTrace(const char* filename)
+{
+	FILE* fp;
+#ifdef _WIN32
+	if (fopen_s(&fp, filename, "w") != 0)
+		fp = nullptr;
+#else
+	fp = fopen(filename, "w");
+#endif
+	if (fp == nullptr)
+		return false;
+
+	JobRecord* records = (JobRecord*)g_memory->AllocTrack(sizeof(JobRecord) * JobProfile::MaxEvents, __FILE__, __LINE__);
+	uint32 numRecords = copyRecords(records);
+
+	const char* priorities[] = { "FrameCritical", "LoadCritical", "Background" };
+
+	// thread 0 is the main thread and the workers come after it
+	fprintf(fp, "{\"traceEvents\":[\n");
+	fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Main thread\"}}");
+	for (uint32 i = 0; i < m_data->NumThreads; i++)
+		fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Worker %u\"}}", i + 1, i);
+
+	for (uint32 i = 0; i < numRecords; i++)
+	{
+		char name[256];
+		escapeJson(name, sizeof(name), records[i].Name ? records[i].Name : "unnamed");
+		const char* priority = priorities[(uint32)records[i].Priority];
+		JobTimings* t = &records[i].Timings;
+
+		// time spent waiting in a queue shows up as an async span, since it doesn't belong to any thread
+		if (t->AsyncStarted > 0)
+		{
+			fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"queued\",\"ph\":\"b\",\"id\":%u,\"ts\":%llu,\"pid\":1,\"tid\":0}", name, i, (unsigned long long)t->Queued);
+			fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"queued\",\"ph\":\"e\",\"id\":%u,\"ts\":%llu,\"pid\":1,\"tid\":0}", name, i, (unsigned long long)t->AsyncStarted);
+			fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"async\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%d,\"args\":{\"priority\":\"%s\"}}",
+				name, (unsigned long long)t->AsyncStarted, (unsigned long long)(t->AsyncFinished - t->AsyncStarted), t->Thread + 1, priority);
+		}
+
+		if (t->MainThreadStarted > 0)
+		{
+			uint64 ready = t->AsyncFinished > 0 ? t->AsyncFinished : t->Queued;
+			fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"main thread wait\",\"ph\":\"b\",\"id\":%u,\"ts\":%llu,\"pid\":1,\"tid\":0}", name, i, (unsigned long long)ready);
+			fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"main thread wait\",\"ph\":\"e\",\"id\":%u,\"ts\":%llu,\"pid\":1,\"tid\":0}", name, i, (unsigned long long)t->MainThreadStarted);
+			fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"main thread\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":0,\"args\":{\"priority\":\"%s\"}}",
+				name, (unsigned long long)t->MainThreadStarted, (unsigned long long)(t->MainThreadFinished - t->MainThreadStarted), priority);
+		}
+	}
+
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+
+	g_memory->FreeTrack(records, __FILE__, __LINE__);
+
+	return true;
+}
+#endif
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+// getcontext() can return twice, so it gets a function of its own where there aren't any locals for it
+// to clobber. The context only needs to be valid for makecontext(), which replaces where it goes anyway.
+static __attribute__((noinline)) void captureContext(ucontext_t* context)
+{
+	getcontext(context);
+}
+
+uint32 JobQueue::allocFiber()
+{
+	uint32 fiber = NoFiber;
+
+	while (m_data->FiberLock.test_and_set(std::memory_order_acquire));
+	if (m_data->NumFreeFibers > 0)
+		fiber = m_data->FreeFibers[--m_data->NumFreeFibers];
+	else if (m_data->NumFibers < JobQueueData::MaxFibers)
+		fiber = m_data->NumFibers++;
+	m_data->FiberLock.clear(std::memory_order_release);
+
+	if (fiber == NoFiber)
+		return NoFiber;
+
+	JobFiber* f = &m_data->Fibers[fiber];
+	const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	if (f->Stack == nullptr)
+	{
+		void* stack = mmap(nullptr, JobQueueData::FiberStackSize + pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (stack == MAP_FAILED)
+		{
+			freeFiber(fiber);
+			return NoFiber;
+		}
+
+		// leave a guard page at the bottom so running out of stack crashes right away instead of trashing something
+		mprotect(stack, pageSize, PROT_NONE);
+		f->Stack = stack;
+	}
+
+	// start it over from the top
+	captureContext(&f->Context);
+	f->Context.uc_stack.ss_sp = (uint8*)f->Stack + pageSize;
+	f->Context.uc_stack.ss_size = JobQueueData::FiberStackSize;
+	f->Context.uc_link = nullptr;
+	makecontext(&f->Context, fiberProc, 0);
+
+	return fiber;
+}
+
+void JobQueue::freeFiber(uint32 fiber)
+{
+	while (m_data->FiberLock.test_and_set(std::memory_order_acquire));
+	m_data->FreeFibers[m_data->NumFreeFibers++] = fiber;
+	m_data->FiberLock.clear(std::memory_order_release);
+}
+
+void JobQueue::fiberProc()
+{
+	afterSwitch();
+	workerLoop();
+
+	// shutting down, so go back to the thread's own stack so the thread can exit
+	JobWorker* worker = &m_data->Workers[getThreadState()->WorkerIndex];
+	worker->PendingFree = worker->CurrentFiber;
+	worker->CurrentFiber = NoFiber;
+	setcontext(&worker->Context);
+}
+
+void JobQueue::afterSwitch()
+{
+	JobWorker* worker = &m_data->Workers[getThreadState()->WorkerIndex];
+
+	if (worker->PendingFree != NoFiber)
+	{
+		uint32 fiber = worker->PendingFree;
+		worker->PendingFree = NoFiber;
+		freeFiber(fiber);
+	}
+
+	if (worker->PendingWait != NoFiber)
+	{
+		uint32 fiber = worker->PendingWait;
+		worker->PendingWait = NoFiber;
+		parkFiber(fiber, worker->PendingWaitJob);
+	}
+}
+
+void JobQueue::parkFiber(uint32 fiber, JobHandle job)
+{
+	Job* j = getJob(JOB_GET_INDEX(job));
+	uint64 checksum = job >> 16;
+
+	uint64 waiters = j->Waiters.load(std::memory_order_acquire);
+	while ((waiters >> 32) == checksum)
+	{
+		m_data->Fibers[fiber].NextWaiter = (uint32)waiters;
+		if (j->Waiters.compare_exchange_weak(waiters, (checksum << 32) | fiber, std::memory_order_release, std::memory_order_acquire))
+			return;
+	}
+
+	// the job finished before we could start waiting on it
+	readyFiber(fiber);
+}
+
+void JobQueue::readyFiber(uint32 fiber)
+{
+	bool queued = m_data->ReadyFibers.Enqueue(fiber);
+	assert(queued && "Ready fiber queue should always have room for every fiber");
+	(void)queued;
+
+	m_data->NumJobs++;
+	wakeWorker();
+}
+
+void JobQueue::wakeWaiters(uint32 index)
+{
+	// the checksum has already moved on, so nobody else can start waiting once the list is swapped out
+	Job* job = getJob(index);
+	uint64 waiters = job->Waiters.exchange(((uint64)job->Checksum << 32) | NoFiber, std::memory_order_acq_rel);
+
+	uint32 fiber = (uint32)waiters;
+	while (fiber != NoFiber)
+	{
+		uint32 next = m_data->Fibers[fiber].NextWaiter;
+		readyFiber(fiber);
+		fiber = next;
+	}
+}
+#endif
+
+TaskGraph::TaskGraph()
+	: m_graph()
+{
+	m_graph.Root = JobQueue::INVALID_JOB;
+}
+
+TaskID TaskGraph::AddTask(JobFunc func, void* param)
+{
+	if (m_graph.NumTasks >= TaskGraphData::MaxTasks)
+		return INVALID_TASK;
+
+	TaskGraphData::Task* task = &m_graph.Tasks[m_graph.NumTasks];
+	task->Func = func;
+	task->Param = param;
+	task->NumPredecessors = 0;
+	task->NumSuccessors = 0;
+
+	return m_graph.NumTasks++;
+}
+
+bool TaskGraph::AddDependency(TaskID before, TaskID after)
+{
+	if (before >= m_graph.NumTasks || after >= m_graph.NumTasks || before == after)
+		return false;
+
+	TaskGraphData::Task* task = &m_graph.Tasks[before];
+	if (task->NumSuccessors >= TaskGraphData::MaxSuccessors)
+		return false;
+
+	task->Successors[task->NumSuccessors++] = (uint8)after;
+	m_graph.Tasks[after].NumPredecessors++;
+
+	return true;
+}
+
+JobHandle TaskGraph::Submit(JobInfo* result, JobPriority priority)
+{
+	// make sure there aren't any cycles, otherwise some tasks would never run
+	uint32 pending[TaskGraphData::MaxTasks];
+	uint32 ready[TaskGraphData::MaxTasks];
+	uint32 numReady = 0;
+	for (uint32 i = 0; i < m_graph.NumTasks; i++)
+	{
+		pending[i] = m_graph.Tasks[i].NumPredecessors;
+		if (pending[i] == 0)
+			ready[numReady++] = i;
+	}
+	for (uint32 i = 0; i < numReady; i++)
+	{
+		TaskGraphData::Task* task = &m_graph.Tasks[ready[i]];
+		for (uint32 j = 0; j < task->NumSuccessors; j++)
+		{
+			if (--pending[task->Successors[j]] == 0)
+				ready[numReady++] = task->Successors[j];
+		}
+	}
+
+	if (numReady != m_graph.NumTasks)
+	{
+		if (result)
+		{
+			(*result).Result = JobResult::Error;
+			(*result).Job = JobQueue::INVALID_JOB;
+		}
+		return JobQueue::INVALID_JOB;
+	}
+
+	return JobQueue::AddJob(rootJob, nullptr, result, &m_graph, sizeof(TaskGraphData), priority, 0, "TaskGraph");
+}
+
+bool TaskGraph::Run(JobPriority priority)
+{
+	JobInfo result;
+	if (Submit(&result, priority) == JobQueue::INVALID_JOB)
+		return false;
+
+	JobQueue::WaitForJob(&result);
+
+	return result.Result == JobResult::Completed;
+}
+
+bool TaskGraph::rootJob(void* data)
+{
+	// every task is a child of the root job, so the root (and the graph, which lives in its data)
+	// sticks around until they're all done
+
+	TaskGraphData* graph = (TaskGraphData*)data;
+	graph->Root = JobQueue::GetCurrentJob();
+	graph->Failed = false;
+
+	for (uint32 i = 0; i < graph->NumTasks; i++)
+		graph->Tasks[i].NumPending = graph->Tasks[i].NumPredecessors;
+
+	for (uint32 i = 0; i < graph->NumTasks; i++)
+	{
+		if (graph->Tasks[i].NumPredecessors == 0)
+			startTask(graph, i);
+	}
+
+	return true;
+}
+
+struct TaskJobData
+{
+	TaskGraphData* Graph;
+	uint32 Task;
+};
+
+bool TaskGraph::taskJob(void* data)
+{
+	TaskJobData* d = (TaskJobData*)data;
+	TaskGraphData::Task* task = &d->Graph->Tasks[d->Task];
+
+	bool success = false;
+	if (d->Graph->Failed == false)
+	{
+		success = task->Func == nullptr || task->Func(task->Param);
+		if (success == false)
+			d->Graph->Failed = true;
+	}
+
+	// start anything that was only waiting on this task (even if it failed, so the graph still finishes)
+	for (uint32 i = 0; i < task->NumSuccessors; i++)
+	{
+		uint32 successor = task->Successors[i];
+		if (d->Graph->Tasks[successor].NumPending.fetch_sub(1) == 1)
+			startTask(d->Graph, successor);
+	}
+
+	return success;
+}
+
+void TaskGraph::startTask(TaskGraphData* graph, uint32 task)
+{
+	TaskJobData d;
+	d.Graph = graph;
+	d.Task = task;
+
+	if (JobQueue::AddDependantJob(graph->Root, taskJob, nullptr, nullptr, &d, sizeof(TaskJobData)) == JobQueue::INVALID_JOB)
+	{
+		// couldn't get a job for it, so just run it here
+		if (taskJob(&d) == false)
+			JobQueue::getJob(JOB_GET_INDEX(graph->Root))->Failed = true;
+	}
 }
@@ -4,13 +4,29 @@
 #include <atomic>
 
 #include "Common.h"
+#include "Utils.h"
 #ifdef _WIN32
 #include "CleanWindows.h"
 #else
 #include <pthread.h>
 #endif
 
+// With fibers, a job that calls WaitForJob() from a worker is put to sleep and the worker moves on
+// to other jobs. Only Linux has them for now. Everywhere else (or with GAME_DISABLE_JOB_FIBERS) the
+// worker runs other jobs itself until the one it's waiting on is done.
+#if defined __linux__ && !defined GAME_DISABLE_JOB_FIBERS
+#define GAME_ENABLE_JOB_FIBERS
+#include <ucontext.h>
+#endif
+
+// Jobs record when they were queued, started, and finished, which the job_histograms and job_trace
+// console commands report on. It's left out of release builds.
+#if !defined NDEBUG && !defined GAME_DISABLE_JOB_PROFILING
+#define GAME_ENABLE_JOB_PROFILING
+#endif
+
 typedef bool(*JobFunc)(void*);
+typedef void(*ParallelForFunc)(uint32 start, uint32 end, void* param);
 
 enum class JobState : uint8
 {
@@ -28,31 +44,228 @@ enum class JobResult
 	Pending,
 	WaitingOnChildren,
 	Completed,
-	Error
+	Error,
+	Cancelled
 };
 
+// what a job is up to, according to JobQueue::GetStatus()
+enum class JobStatus : uint8
+{
+	Done, // finished (or the handle's no good). The job's JobInfo says how it went.
+	Queued,
+	Running,
+	WaitingForMainThread,
+	WaitingOnChildren
+};
+
+// Workers always take jobs from the most urgent class that has any, but every so often they
+// look at the less urgent classes first so those can't get starved forever.
+enum class JobPriority : uint8
+{
+	FrameCritical, // needed this frame (somebody is probably waiting on it)
+	LoadCritical,  // needed soon, like a texture for a model that's already visible
+	Background     // prefetching and anything else that can wait
+};
+
+// the top 16 bits are the slot's checksum, the bottom 16 are the slot's index (just like WaitHandle)
 typedef uint32 JobHandle;
 
 struct JobInfo
 {
-	volatile JobResult Result;
-	JobHandle Job;
+	std::atomic<JobResult> Result;
+	std::atomic<JobHandle> Job;
 };
 
+#ifdef GAME_ENABLE_JOB_PROFILING
+// microseconds on JobQueueData::Clock, or 0 if it didn't happen
+struct JobTimings
+{
+	uint64 Queued;
+	uint64 AsyncStarted;
+	uint64 AsyncFinished;
+	uint64 MainThreadStarted;
+	uint64 MainThreadFinished;
+	int32 Thread; // the worker that ran AsyncFunc
+};
+
+struct JobRecord
+{
+	const char* Name;
+	JobPriority Priority;
+	JobTimings Timings;
+};
+
+struct JobProfileEvent
+{
+	std::atomic<uint32> Sequence; // odd while it's being written
+	JobRecord Record;
+};
+
+// the most recent jobs to finish, oldest ones get overwritten
+struct JobProfile
+{
+	static const uint32 MaxEvents = 8192;
+
+	std::atomic<uint32> NextEvent;
+	JobProfileEvent Events[MaxEvents];
+};
+#endif
+
 struct Job
 {
 	JobFunc AsyncFunc;
 	JobFunc MainThreadFunc;
 	uint32 ParentIndex;
 	JobInfo* Result;
+	std::atomic<bool> Failed;
+
+	// when checksum is even (or 0) that means the slot is free, otherwise it's in use
+	std::atomic<uint16> Checksum;
+	std::atomic<uint16> CancelledChecksum; // the job's been cancelled if this matches Checksum
+	std::atomic<JobState> State;
+	std::atomic<int32> DependantJobCount;
+	std::atomic<uint32> NextFree;
+
+	JobPriority Priority;
+	uint64 Deadline; // microseconds on JobQueueData::Clock, or 0 if there isn't one
+	const char* Name;
+
+#ifdef GAME_ENABLE_JOB_PROFILING
+	JobTimings Timings;
+#endif
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+	// fibers waiting for this job to finish. The top 32 bits are the checksum of the job they're
+	// waiting on (so nobody can start waiting on a slot that's been reused), the bottom 32 are the first fiber.
+	std::atomic<uint64> Waiters;
+#endif
+
+	// points at Data, or at a buffer from the payload pool if the job's data didn't fit
+	void* Payload;
+	int32 PayloadSizeClass;
 
 	static const uint32 MaxDataSize = 128;
 	alignas(16) uint8 Data[MaxDataSize];
 };
 
+// Jobs are allocated in blocks as they're needed, so the pool can grow without
+// moving any jobs that are already in use.
+struct JobBlock
+{
+	static const uint32 Size = 256;
+	Job Jobs[Size];
+};
+
+// Job data that's bigger than Job::MaxDataSize goes in a buffer from here. There's a
+// free list for each power-of-2 size, and the buffers don't go back to the system
+// until the job queue shuts down.
+struct JobPayloadPool
+{
+	static const uint32 MinSize = 256;
+	static const uint32 NumSizeClasses = 9;
+	static const uint32 MaxSize = MinSize << (NumSizeClasses - 1); // 64k
+	static const uint32 PageSize = 64 * 1024;
+
+	std::atomic_flag Locks[NumSizeClasses];
+	void* FreeLists[NumSizeClasses];
+
+	// every page that's been allocated, linked through the first pointer of each page
+	std::atomic_flag PageLock;
+	void* Pages;
+};
+
+// Chase-Lev work-stealing deque of job indices. Only the owning worker pushes and pops
+// (from the bottom), any other thread may steal (from the top). Capacity must be at least
+// JobQueueData::MaxJobs so a push can never fail.
+struct JobDeque
+{
+	static const uint32 Capacity = 16384;
+
+	alignas(64) std::atomic<int64> Top;
+	alignas(64) std::atomic<int64> Bottom;
+	std::atomic<uint32> Items[Capacity];
+
+	bool Push(uint32 job);
+	bool Pop(uint32* job);
+	bool Steal(uint32* job);
+};
+
+// Bounded multi-producer/multi-consumer queue of job indices. Used for jobs added from
+// threads that aren't workers (usually the main thread), and for jobs that are waiting
+// for the main thread to run their MainThreadFunc.
+struct JobIndexQueue
+{
+	static const uint32 Capacity = 16384;
+
+	struct Cell
+	{
+		std::atomic<uint32> Sequence;
+		uint32 Job;
+	};
+
+	alignas(64) std::atomic<uint32> EnqueuePosition;
+	alignas(64) std::atomic<uint32> DequeuePosition;
+	Cell Cells[Capacity];
+
+	void Init();
+	bool Enqueue(uint32 job);
+	bool Dequeue(uint32* job);
+};
+
+// Jobs that have a deadline wait in one of these instead of a deque, earliest deadline first.
+// If it's full the job just goes in the regular queues.
+struct JobDeadlineHeap
+{
+	static const uint32 Capacity = 1024;
+	static const uint64 NoDeadline = ~(uint64)0;
+
+	struct Entry
+	{
+		uint64 Deadline;
+		uint32 Job;
+	};
+
+	std::atomic_flag Lock;
+	std::atomic<uint64> Earliest; // so workers can check for overdue jobs without taking the lock
+	uint32 Count;
+	Entry Entries[Capacity];
+
+	void Init();
+	bool Push(uint64 deadline, uint32 job);
+	bool Pop(uint32* job);
+};
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+struct JobFiber
+{
+	ucontext_t Context;
+	void* Stack;
+	uint32 NextWaiter; // the next fiber waiting on the same job
+};
+
+struct JobWorker
+{
+	ucontext_t Context; // the thread's own stack, which it goes back to when it's time to exit
+	uint32 CurrentFiber;
+
+	// things the fiber being switched to has to take care of, since the old fiber isn't safe to
+	// touch until it's been switched away from
+	uint32 PendingFree;
+	uint32 PendingWait;
+	JobHandle PendingWaitJob;
+};
+#endif
+
 struct JobQueueData
 {
-	static const uint32 MaxThreads = 8;
+	// the most worker threads there can be (WaitForMultipleObjects() can't handle more than 64)
+	static const uint32 MaxThreads = 64;
+	uint32 NumThreads;
+
+	// how many times an idle worker checks for new jobs before going to sleep
+	static const uint32 IdleSpinCount = 2000;
+	uint32 SpinCount;
+	bool PinThreads;
 #ifdef _WIN32
 	HANDLE Threads[MaxThreads];
 	CONDITION_VARIABLE Signal;
@@ -63,11 +276,52 @@ struct JobQueueData
 	pthread_mutex_t Lock;
 #endif
 
-	static const uint32 MaxJobs = 100;
-	Job Jobs[MaxJobs];
-	std::atomic<JobState> JobStates[MaxJobs];
-	std::atomic<int32> DependantJobCount[MaxJobs];
-	std::atomic<uint32> NumJobs;
+	// the pool starts with one block and grows up to MaxJobBlocks (handles only have room for a 16 bit index)
+	static const uint32 MaxJobBlocks = 64;
+	static const uint32 MaxJobs = MaxJobBlocks * JobBlock::Size;
+	JobBlock* Blocks[MaxJobBlocks];
+	std::atomic<uint32> NumBlocks;
+
+	std::atomic<uint32> NumJobs;          // jobs that are queued but haven't been picked up by a worker
+	std::atomic<uint32> NumActiveJobs;    // jobs that have a slot
+	std::atomic<uint32> NumSleepingThreads;
+
+	// each priority class has its own set of queues
+	static const uint32 NumPriorities = 3;
+	std::atomic<uint32> QueueDepth[NumPriorities]; // jobs in each class that haven't been picked up
+
+	// how many jobs in a row a worker can pick while less urgent jobs are waiting before
+	// it picks one of those instead
+	static const uint32 MaxStarvedPicks = 8;
+
+	// free slots are kept on a stack. The top 32 bits of FreeListHead are a tag to avoid ABA.
+	std::atomic<uint64> FreeListHead;
+
+	JobPayloadPool Payloads;
+
+	JobIndexQueue Injected[NumPriorities];
+	JobIndexQueue MainThreadQueue[NumPriorities];
+	JobDeadlineHeap Deadlines[NumPriorities];
+	JobDeque* Deques; // NumPriorities for each worker
+
+	Utils::Stopwatch Clock; // deadlines and profiling are measured on this
+
+#ifdef GAME_ENABLE_JOB_PROFILING
+	JobProfile Profile;
+#endif
+
+#ifdef GAME_ENABLE_JOB_FIBERS
+	// Fibers are created as they're needed. Waiting jobs keep theirs until they're woken up.
+	static const uint32 MaxFibers = 128;
+	static const uint32 FiberStackSize = 256 * 1024;
+	JobFiber Fibers[MaxFibers];
+	JobWorker Workers[MaxThreads];
+	std::atomic_flag FiberLock;
+	uint32 FreeFibers[MaxFibers];
+	uint32 NumFreeFibers;
+	uint32 NumFibers;
+	JobIndexQueue ReadyFibers; // fibers whose job is done waiting
+#endif
 
 	std::atomic<bool> Active;
 };
@@ -77,16 +331,70 @@ class JobQueue
 	static JobQueueData* m_data;
 
 public:
-	static void SetGlobalData(JobQueueData** data);
+	static const JobHandle INVALID_JOB = (JobHandle)-1;
 
+	// If numThreads is 0 then there's one worker for each core, minus one for the main thread.
+	// If pinThreads is true then each worker is locked to its own core.
+	static void SetGlobalData(JobQueueData** data, uint32 numThreads, bool pinThreads);
+
+	static void Init();
 	static void Shutdown(bool complete);
 
-	static JobHandle AddJob(JobFunc asyncFunc, JobFunc mainThreadFunc, JobInfo* result, void* data, size_t dataSize);
-	static JobHandle AddDependantJob(uint32 parentJobHandle, JobFunc asyncFunc, JobFunc mainThreadFunc, JobInfo* result, void* data, size_t dataSize);
+	// data is copied, so it doesn't need to stay around after these return. dataSize can be up to JobPayloadPool::MaxSize.
+	// If deadlineMicroseconds isn't 0 then the job is picked ahead of everything else once it's that late,
+	// and before jobs in its class that don't have a deadline. Dependant jobs get their parent's priority.
+	// name is only used for profiling, so it has to be a string that sticks around (like a literal).
+	// Dependant jobs without a name get their parent's.
+	static JobHandle AddJob(JobFunc asyncFunc, JobFunc mainThreadFunc, JobInfo* result, void* data, size_t dataSize,
+		JobPriority priority = JobPriority::LoadCritical, uint32 deadlineMicroseconds = 0, const char* name = nullptr);
+	static JobHandle AddDependantJob(JobHandle parentJobHandle, JobFunc asyncFunc, JobFunc mainThreadFunc, JobInfo* result, void* data, size_t dataSize,
+		uint32 deadlineMicroseconds = 0, const char* name = nullptr);
+
+	// On the main thread this runs Tick() while it waits, on a worker it runs other jobs. Inside a job
+	// the JobHandle version is better, since it doesn't tie up the worker.
+	static void WaitForJob(JobInfo* info);
+
+	// Waits until the job (and all its children) are done. Inside a job this puts the job to sleep
+	// (when there are fibers) so the worker can keep going, otherwise the thread helps out by running
+	// other jobs in the meantime. The job's JobInfo has the result.
+	static void WaitForJob(JobHandle job);
+
+	// Jobs that haven't started yet are dropped without running. Running jobs keep going, but can
+	// check IsCancelled() and give up early. Either way the job (and its children) finish with
+	// JobResult::Cancelled. Returns false if the job was already done.
+	static bool Cancel(JobHandle job);
+
+	// whether the job running on this thread (or any of its parents) has been cancelled
+	static bool IsCancelled();
+
+	static JobStatus GetStatus(JobHandle job);
+
+	// Runs MainThreadFuncs of any jobs that are ready, most urgent first. If budgetMicroseconds isn't 0
+	// then Tick() stops once the budget is used up and leaves the rest for the next call (at least one
+	// job from each class always runs, so callers that loop on Tick() still make progress).
+	static void Tick(uint32 budgetMicroseconds = 0);
+
+	// Calls func on [begin, end) in chunks of up to grain items, spread across the workers.
+	// The calling thread works on chunks too, and doesn't return until they're all done. The helper jobs
+	// get the priority of the job that's calling it (FrameCritical when it's called from the main thread).
+	static void ParallelFor(uint32 begin, uint32 end, uint32 grain, ParallelForFunc func, void* param);
+
+	// the handle of the job running on this thread, or INVALID_JOB
+	static JobHandle GetCurrentJob();
+
+	// the index of the worker running on this thread, or -1 if it isn't a worker (like the main thread)
+	static int32 GetCurrentWorker();
 
-	static void WaitForJob(volatile JobResult* result);
+	// how many jobs of the given priority are waiting for a worker
+	static uint32 GetQueueDepth(JobPriority priority);
 
-	static void Tick();
+#ifdef GAME_ENABLE_JOB_PROFILING
+	// Logs histograms of how long recent jobs waited to be picked up, ran, and waited for the main thread.
+	static void LogHistograms();
+
+	// writes recent jobs to a file that chrome://tracing can load
+	static bool WriteTrace(const char* filename);
+#endif
 
 private:
 #ifdef _WIN32
@@ -94,8 +402,101 @@ private:
 #else
 	static void* threadProc(void* param);
 #endif
+	static void workerLoop();
+
+	static Job* getJob(uint32 index) { return &m_data->Blocks[index / JobBlock::Size]->Jobs[index % JobBlock::Size]; }
+
+	static uint32 allocJob();
+	static void freeJob(uint32 index);
+	static bool growPool();
+	static void* allocPayload(size_t size, int32* sizeClass);
+	static void freePayload(void* payload, int32 sizeClass);
+	static JobHandle addJob(JobHandle parentJobHandle, JobPriority priority, uint32 deadlineMicroseconds, const char* name, JobFunc asyncFunc, JobFunc mainThreadFunc, JobInfo* result, void* data, size_t dataSize);
+	static void pushJob(uint32 index);
+	static bool findJob(int32 workerIndex, uint32* index);
+	static bool findJob(int32 workerIndex, uint32 priority, uint32* index);
+	static void runJob(uint32 index);
+	static void finishJob(uint32 index, bool success);
+
+	static inline void cleanupJob(uint32 index, JobState state, JobResult result);
+
+	static bool parallelForJob(void* data);
+
+	static bool isJobAlive(JobHandle job);
+	static bool isCancelled(uint32 index);
+#ifdef GAME_ENABLE_JOB_PROFILING
+	static uint64 now() { return m_data->Clock.GetElapsedMicroseconds(); }
+	static void recordJob(uint32 index);
+	static uint32 copyRecords(JobRecord* records);
+#endif
+#ifdef GAME_ENABLE_JOB_FIBERS
+	static uint32 allocFiber();
+	static void freeFiber(uint32 fiber);
+	static void fiberProc();
+	static void afterSwitch();
+	static void parkFiber(uint32 fiber, JobHandle job);
+	static void readyFiber(uint32 fiber);
+	static void wakeWaiters(uint32 index);
+#endif
+	static void wakeWorker();
+
+	friend class TaskGraph;
+};
+
+typedef uint32 TaskID;
+
+struct TaskGraphData
+{
+	static const uint32 MaxTasks = 64;
+	static const uint32 MaxSuccessors = 8;
 
-	static inline void cleanupJob(uint32 index, JobState state);
+	struct Task
+	{
+		JobFunc Func;
+		void* Param;
+		uint32 NumPredecessors;
+		std::atomic<uint32> NumPending;
+		uint32 NumSuccessors;
+		uint8 Successors[MaxSuccessors];
+	};
+
+	JobHandle Root;
+	uint32 NumTasks;
+	Task Tasks[MaxTasks];
+	std::atomic<bool> Failed;
+};
+
+// Builds a set of tasks with dependencies between them, then runs them all on the job queue.
+// A task runs once all the tasks it depends on are done. If a task fails then the tasks
+// after it are skipped and the whole graph reports JobResult::Error.
+// Tasks get their param pointer as-is, so whatever it points to has to stick around until the graph is done.
+class TaskGraph
+{
+	TaskGraphData m_graph;
+
+public:
+	static const TaskID INVALID_TASK = (TaskID)-1;
+
+	TaskGraph();
+
+	TaskID AddTask(JobFunc func, void* param);
+
+	// "after" won't start until "before" is done
+	bool AddDependency(TaskID before, TaskID after);
+
+	// The graph is copied, so this TaskGraph can be reused or thrown away once this returns.
+	// result works just like it does with JobQueue::AddJob(). Every task gets the graph's priority.
+	JobHandle Submit(JobInfo* result, JobPriority priority = JobPriority::LoadCritical);
+
+	// submits the graph and waits for it to finish (so only call it from the main thread)
+	bool Run(JobPriority priority = JobPriority::FrameCritical);
+
+private:
+	static bool rootJob(void* data);
+	static bool taskJob(void* data);
+	static void startTask(TaskGraphData* graph, uint32 task);
 };
 
+#define JOB_GET_INDEX(j) (j & 0xffff)
+
 #endif // JOBQUEUE_H
@@ -0,0 +1,223 @@
+#include "MemoryBudgets.h"
+#include "MemoryManager.h"
+#include "FileFinder.h"
+#include "Logging.h"
+#include "ConsoleCommand.h"
+#include "Gui/Console.h"
+#include "iniparse.h"
+
+static const uint32 NumTags = (uint32)MemoryTag::LAST;
+
+// what Check() saw last time. These get reset when the game lib reloads, so Check() starts over without complaining.
+static bool g_seen = false;
+static uint32 g_softCrossings[NumTags];
+static uint32 g_hardCrossings[NumTags];
+static uint32 g_auditCallsites;
+
+static const uint32 MaxAuditResults = 64;
+
+static bool findTag(const char* name, uint32 length, MemoryTag* result)
+{
+	for (uint32 i = 0; i < NumTags; i++)
+	{
+		const char* tagName = GetMemoryTagName((MemoryTag)i);
+		if (strlen(tagName) == length && strncmp(tagName, name, length) == 0)
+		{
+			*result = (MemoryTag)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static float toMegabytes(size_t bytes)
+{
+	return bytes / (1024.0f * 1024.0f);
+}
+
+static void cmdMemoryStats(const char*)
+{
+	MemoryStats stats;
+	g_memory->GetStats(&stats);
+
+	WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "Permanent memory: %.2f / %.2f MB", toMegabytes(stats.KeepUsed), toMegabytes(stats.KeepSize));
+
+	if (stats.Tracking == false)
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "Memory tracking is off, so sizes include allocator rounding (build with GAME_ENABLE_MEMORY_TRACKING for exact ones)");
+
+	for (uint32 i = 0; i < NumTags; i++)
+	{
+		MemoryTagStats* tag = &stats.Tags[i];
+
+		if (tag->HardBudget != 0 || tag->SoftBudget != 0)
+		{
+			WriteLog(tag->Current > tag->HardBudget && tag->HardBudget != 0 ? LogSeverityType::Error :
+				tag->Current > tag->SoftBudget && tag->SoftBudget != 0 ? LogSeverityType::Warning : LogSeverityType::Normal,
+				LogChannelType::ConsoleOutput, "%-16s %8.2f MB (peak %.2f MB) in %u allocations, budget %.2f / %.2f MB",
+				GetMemoryTagName((MemoryTag)i), toMegabytes(tag->Current), toMegabytes(tag->Peak), tag->Count,
+				toMegabytes(tag->SoftBudget), toMegabytes(tag->HardBudget));
+		}
+		else
+		{
+			WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%-16s %8.2f MB (peak %.2f MB) in %u allocations",
+				GetMemoryTagName((MemoryTag)i), toMegabytes(tag->Current), toMegabytes(tag->Peak), tag->Count);
+		}
+	}
+}
+
+// mem_budget <tag> <soft MB> <hard MB>
+static void cmdMemoryBudget(const char* param)
+{
+	const char* nameEnd = param;
+	while (*nameEnd != ' ' && *nameEnd != 0) nameEnd++;
+
+	MemoryTag tag;
+	if (findTag(param, (uint32)(nameEnd - param), &tag) == false)
+	{
+		WriteLog(LogSeverityType::Error, LogChannelType::ConsoleOutput, "Usage: mem_budget <tag> <soft MB> <hard MB>");
+		return;
+	}
+
+	char* end;
+	float soft = strtof(nameEnd, &end);
+	float hard = strtof(end, nullptr);
+
+	g_memory->SetBudget(tag, (size_t)(soft * 1024 * 1024), (size_t)(hard * 1024 * 1024));
+	WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%s budget is now %.2f / %.2f MB", GetMemoryTagName(tag), soft, hard);
+}
+
+static void cmdMemoryReport(const char* param)
+{
+	const char* filename = param != nullptr && param[0] != 0 ? param : "memory_report.json";
+
+	g_memory->DumpReport(filename);
+	WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "Wrote %s", filename);
+}
+
+// mem_audit [off|count|abort|reset]. With no parameters it shows what's been caught so far.
+static void cmdMemoryAudit(const char* param)
+{
+	if (strcmp(param, "off") == 0)
+		g_memory->SetAuditMode(MemoryAuditMode::Off);
+	else if (strcmp(param, "count") == 0)
+		g_memory->SetAuditMode(MemoryAuditMode::Count);
+	else if (strcmp(param, "abort") == 0)
+		g_memory->SetAuditMode(MemoryAuditMode::Abort);
+	else if (strcmp(param, "reset") == 0)
+		g_memory->ResetAudit();
+	else if (param[0] != 0)
+		WriteLog(LogSeverityType::Error, LogChannelType::ConsoleOutput, "Usage: mem_audit [off|count|abort|reset]");
+	else
+	{
+		MemoryStats stats;
+		g_memory->GetStats(&stats);
+
+		MemoryAuditEntry entries[MaxAuditResults];
+		uint32 numEntries = g_memory->GetAuditResults(entries, MaxAuditResults);
+
+		WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%u heap calls from %u places since the steady state began", stats.AuditHits, numEntries);
+		for (uint32 i = 0; i < numEntries && i < MaxAuditResults; i++)
+		{
+			WriteLog(LogSeverityType::Normal, LogChannelType::ConsoleOutput, "%s:%u: %u allocs, %u reallocs, %u frees",
+				entries[i].Filename != nullptr ? entries[i].Filename : "(unknown)", entries[i].Line, entries[i].Allocs, entries[i].Reallocs, entries[i].Frees);
+		}
+	}
+}
+
+void MemoryBudgets::Init(const char* budgetFile)
+{
+	ConsoleCommand cmd[] = {
+		{ "mem_stats", cmdMemoryStats },
+		{ "mem_budget", cmdMemoryBudget },
+		{ "mem_report", cmdMemoryReport },
+		{ "mem_audit", cmdMemoryAudit }
+	};
+	Gui::Console::AddCommands(cmd, 4);
+
+	// anything that goes over budget while the game is starting up gets reported on the first frame
+	g_seen = true;
+
+	// the budget file is optional, since not having budgets is a perfectly good way to run
+	FoundFile f;
+	if (FileFinder::OpenAndMap(budgetFile, &f) == false)
+		return;
+
+	ini_context ctx;
+	ini_item item;
+	ini_init(&ctx, (const char*)f.Memory, (const char*)f.Memory + f.FileSize);
+
+	while (ini_next(&ctx, &item) == ini_result_success)
+	{
+		if (item.type == ini_itemtype::section && ini_section_equals(&ctx, &item, "budget"))
+		{
+			bool foundTag = false;
+			MemoryTag tag = MemoryTag::General;
+			float soft = 0, hard = 0;
+
+			while (ini_next_within_section(&ctx, &item) == ini_result_success)
+			{
+				if (ini_key_equals(&ctx, &item, "tag"))
+					foundTag = findTag(ctx.source + item.keyvalue.value_start, item.keyvalue.value_end - item.keyvalue.value_start, &tag);
+				else if (ini_key_equals(&ctx, &item, "soft"))
+					ini_value_float(&ctx, &item, &soft);
+				else if (ini_key_equals(&ctx, &item, "hard"))
+					ini_value_float(&ctx, &item, &hard);
+			}
+
+			if (foundTag)
+				g_memory->SetBudget(tag, (size_t)(soft * 1024 * 1024), (size_t)(hard * 1024 * 1024));
+			else
+				WriteLog(LogSeverityType::Warning, LogChannelType::Memory, "Ignoring a budget in %s without a valid tag", budgetFile);
+		}
+	}
+
+	FileFinder::Close(&f);
+}
+
+void MemoryBudgets::Check()
+{
+	MemoryStats stats;
+	g_memory->GetStats(&stats);
+
+	// say something the first time each place in the frame path hits the heap
+	if (stats.AuditCallsites < g_auditCallsites)
+		g_auditCallsites = 0; // somebody reset it
+	if (stats.AuditCallsites > g_auditCallsites)
+	{
+		MemoryAuditEntry entries[MaxAuditResults];
+		uint32 numEntries = g_memory->GetAuditResults(entries, MaxAuditResults);
+
+		for (uint32 i = g_auditCallsites; i < numEntries && i < MaxAuditResults; i++)
+		{
+			WriteLog(LogSeverityType::Warning, LogChannelType::Memory, "Heap used during the steady state at %s:%u (see mem_audit)",
+				entries[i].Filename != nullptr ? entries[i].Filename : "(unknown)", entries[i].Line);
+		}
+
+		g_auditCallsites = numEntries;
+	}
+
+	for (uint32 i = 0; i < NumTags; i++)
+	{
+		MemoryTagStats* tag = &stats.Tags[i];
+
+		if (g_seen)
+		{
+			if (tag->HardBudgetCrossings != g_hardCrossings[i])
+			{
+				WriteLog(LogSeverityType::Error, LogChannelType::Memory, "%s went over its hard budget of %.2f MB (now %.2f MB, peak %.2f MB)",
+					GetMemoryTagName((MemoryTag)i), toMegabytes(tag->HardBudget), toMegabytes(tag->Current), toMegabytes(tag->Peak));
+			}
+			else if (tag->SoftBudgetCrossings != g_softCrossings[i])
+			{
+				WriteLog(LogSeverityType::Warning, LogChannelType::Memory, "%s went over its soft budget of %.2f MB (now %.2f MB, peak %.2f MB)",
+					GetMemoryTagName((MemoryTag)i), toMegabytes(tag->SoftBudget), toMegabytes(tag->Current), toMegabytes(tag->Peak));
+			}
+		}
+
+		g_softCrossings[i] = tag->SoftBudgetCrossings;
+		g_hardCrossings[i] = tag->HardBudgetCrossings;
+	}
+
+	g_seen = true;
+}
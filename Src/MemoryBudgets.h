@@ -0,0 +1,18 @@
+#ifndef MEMORYBUDGETS_H
+#define MEMORYBUDGETS_H
+
+#include "Common.h"
+
+// Loads the per-tag memory budgets, adds the memory console commands, and complains
+// when a tag goes over its budget (a warning for the soft budget, an error for the hard one)
+// or when the heap gets used during the steady state.
+class MemoryBudgets
+{
+public:
+	static void Init(const char* budgetFile);
+
+	// main thread, once a frame
+	static void Check();
+};
+
+#endif // MEMORYBUDGETS_H
@@ -1,355 +1,1596 @@
-#include "MemoryManager.h"
-#include <memory>
-#include <atomic>
-#include <cstdio>
-
-#ifdef _WIN32
-#include "CleanWindows.h"
-#endif
-
-#define MEM_BASIC_ALLOC
-
-std::atomic<size_t> g_requestedMemoryUsed = { 0 };
-std::atomic<size_t> g_actualMemoryUsed = { 0 };
-std::atomic<uint32> g_timestamp = { 0 };
-
-namespace MemoryManagerInternal
-{
-	struct AllocInfoMini;
-
-	struct AllocInfo
-	{
-		size_t TotalSize;
-		size_t RequestedSize;
-		size_t Alignment;
-		char Filename[128];
-		uint32 Line;
-		uint32 Timestamp;
-		AllocInfoMini* Mini;
-
-		static const uint32 PaddingAmount = (32 - (sizeof(size_t) * 3 + 128 + sizeof(uint32) * 2 + sizeof(AllocInfoMini*)) % 32) % 32;
-		char Padding[PaddingAmount];
-	};
-
-	struct AllocInfoMini
-	{
-		AllocInfo* Info;
-		size_t RequestedSize;
-	};
-
-	struct AllocInfoPage
-	{
-		AllocInfoMini Allocations[1000];
-		AllocInfoPage* Next;
-		std::atomic<uint32> NumAllocations;
-	};
-
-	AllocInfoPage* g_firstPage;
-	AllocInfoPage* g_currentPage;
-#ifdef _WIN32
-	CRITICAL_SECTION g_lock;
-#else
-	pthread_mutex_t g_lock;
-#endif
-
-	AllocInfoMini* GetNewAlloc()
-	{
-#ifdef _WIN32
-		EnterCriticalSection(&g_lock);
-#else
-		pthread_mutex_lock(&g_lock);
-#endif
-
-		if (g_currentPage->NumAllocations == 1000)
-		{
-			auto newPage = (AllocInfoPage*)malloc(sizeof(AllocInfoPage));
-			newPage->Next = nullptr;
-			newPage->NumAllocations = 0;
-			g_currentPage->Next = newPage;
-			g_currentPage = newPage;
-		}
-
-		auto info = &g_currentPage->Allocations[g_currentPage->NumAllocations++];
-
-#ifdef _WIN32
-		LeaveCriticalSection(&g_lock);
-#else
-		pthread_mutex_unlock(&g_lock);
-#endif
-
-		return info;
-	}
-
-	void Initialize()
-	{
-		g_firstPage = g_currentPage = (AllocInfoPage*)malloc(sizeof(AllocInfoPage));
-		g_currentPage->Next = nullptr;
-		g_currentPage->NumAllocations = 0;
-
-#ifdef _WIN32
-		InitializeCriticalSection(&g_lock);
-#else
-		g_lock = PTHREAD_MUTEX_INITIALIZER;
-#endif
-	}
-
-	void Shutdown()
-	{
-		AllocInfoPage* page = g_firstPage;
-		while (page != nullptr)
-		{
-			auto next = page->Next;
-			free(page);
-			page = next;
-		}
-	}
-
-	void SetDefaults(MemoryManager* manager)
-	{
-		manager->Alloc = MemoryManagerInternal::Alloc;
-		manager->AllocTrack = MemoryManagerInternal::AllocTrack;
-		manager->AlignedAlloc = MemoryManagerInternal::AlignedAlloc;
-		manager->AlignedAllocTrack = MemoryManagerInternal::AlignedAllocTrack;
-		manager->Realloc = MemoryManagerInternal::Realloc;
-		manager->ReallocTrack = MemoryManagerInternal::ReallocTrack;
-		manager->Free = MemoryManagerInternal::Free;
-		manager->FreeTrack = MemoryManagerInternal::FreeTrack;
-		manager->AllocAndKeep = MemoryManagerInternal::AllocAndKeep;
-	}
-
-	void* Alloc(size_t amount)
-	{
-		return AllocTrack(amount, nullptr, 0);
-	}
-	
-	void* AlignedAlloc(size_t amount, size_t alignment)
-	{
-		return AlignedAllocTrack(amount, alignment, nullptr, 0);
-	}
-
-	void* AllocTrack(size_t amount, const char* filename, int line)
-	{
-		size_t alignment;
-		if (amount <= 4)
-			alignment = alignof(float);
-		else if (amount <= 8)
-			alignment = alignof(double);
-		else
-			alignment = 16;
-
-		return AlignedAllocTrack(amount, alignment, filename, line);
-	}
-
-	void* AlignedAllocTrack(size_t amount, size_t alignment, const char* filename, int line)
-	{
-#ifdef MEM_BASIC_ALLOC
-		return malloc(amount);
-#else
-		g_requestedMemoryUsed += amount;
-
-		static_assert(sizeof(AllocInfo) % 32 == 0, "Size of AllocInfo is not a multiple of 32 bytes");
-
-		g_requestedMemoryUsed += amount;
-
-		size_t preSize = sizeof(AllocInfo) + 64;
-		size_t amountToAllocate = preSize + amount + 64;
-		g_actualMemoryUsed += amountToAllocate;
-
-		void* memory = malloc(amountToAllocate);
-
-		// setup the tracking info
-		AllocInfo* info = (AllocInfo*)memory;
-		info->TotalSize = amountToAllocate;
-		info->RequestedSize = amount;
-		info->Alignment = alignment;
-		if (filename != nullptr)
-		{
-#ifdef _WIN32
-			strncpy_s(info->Filename, filename, _TRUNCATE);
-#else
-			strncpy(info->Filename, filename, 128);
-			info->Filename[127] = 0;
-#endif
-		}
-		else
-			info->Filename[0] = 0;
-		info->Line = line;
-		info->Timestamp = g_timestamp++;
-
-		// setup the sentinel values
-		memset((uint8*)memory + sizeof(AllocInfo), 0xb0, 64);
-		memset((uint8*)memory + sizeof(AllocInfo) + 64 + amount, 0xb0, 64);
-
-		// record the allocation
-		auto log = GetNewAlloc();
-		log->Info = info;
-		log->RequestedSize = amount;
-		info->Mini = log;
-
-		return (uint8*)memory + preSize;
-#endif
-	}
-
-	
-	
-
-	void* Realloc(void* original, size_t amount)
-	{
-		return ReallocTrack(original, amount, nullptr, 0);
-	}
-
-	void* ReallocTrack(void* original, size_t amount, const char* filename, int line)
-	{
-		if (original == nullptr)
-			return AllocTrack(amount, filename, line);
-
-#ifdef MEM_BASIC_ALLOC
-		return realloc(original, amount);
-#else
-		size_t amountToAllocate = sizeof(AllocInfo) + 64 + amount + 64;
-
-		AllocInfo* info = (AllocInfo*)((uint8*)original - 64 - sizeof(AllocInfo));
-
-		// check the sentinels
-		for (uint8* mem = (uint8*)original - 64; mem < original; mem++)
-			if (*mem != 0xb0)
-				throw "Memory is corrupt";
-		for (uint8* mem = (uint8*)original + info->RequestedSize; mem < (uint8*)original + info->RequestedSize + 64; mem++)
-			if (*mem != 0xb0)
-				throw "Memory is corrupt";
-
-
-		void* memory = realloc(info, amountToAllocate);
-
-		AllocInfo* newinfo = (AllocInfo*)memory;
-
-		// track memory usage
-		g_actualMemoryUsed += amountToAllocate - newinfo->TotalSize;
-		g_requestedMemoryUsed += amount - newinfo->RequestedSize;
-		
-		newinfo->RequestedSize = amount;
-		newinfo->TotalSize = amountToAllocate;
-		
-		if (filename != nullptr)
-		{
-#ifdef _WIN32
-			strncpy_s(newinfo->Filename, filename, _TRUNCATE);
-#else
-			strncpy(newinfo->Filename, filename, 128);
-			newinfo->Filename[127] = 0;
-#endif
-		}
-		else
-			newinfo->Filename[0] = 0;
-
-		newinfo->Line = line;
-		newinfo->Mini->RequestedSize = amount;
-
-		// set the sentinel values
-		memset((uint8*)memory + sizeof(AllocInfo) + 64 + amount, 0xb0, 64);
-
-		
-
-		return (uint8*)memory + sizeof(AllocInfo) + 64;
-#endif
-	}
-
-	void Free(void* memory)
-	{
-		FreeTrack(memory, nullptr, 0);
-	}
-
-	void FreeTrack(void* memory, const char* filename, int line)
-	{
-#ifdef MEM_BASIC_ALLOC
-		free(memory);
-#else
-		AllocInfo* info = (AllocInfo*)((uint8*)memory - 64 - sizeof(AllocInfo));
-
-		// check the sentinels
-		for (uint8* mem = (uint8*)memory - 64; mem < memory; mem++)
-			if (*mem != 0xb0)
-				throw "Memory is corrupt";
-		for (uint8* mem = (uint8*)memory + info->RequestedSize; mem < (uint8*)memory + info->RequestedSize + 64; mem++)
-			if (*mem != 0xb0)
-				throw "Memory is corrupt";
-
-		// TODO: is there a better way to cause an abort and still possibly get an error message? Almost definitely.
-
-		g_actualMemoryUsed -= info->TotalSize;
-		g_requestedMemoryUsed -= info->RequestedSize;
-
-		info->Mini->Info = nullptr;
-
-		free((uint8*)memory - 64 - sizeof(AllocInfo));
-#endif
-	}
-
-	void* AllocAndKeep(size_t amount, const char* filename, int line)
-	{
-		// TODO: this is for memory that will be allocated and held until the game exits.
-		// It should be excluded from memory-leakage detection.
-		// This will allow the memory manager to potentially do some optimizations, like allocate
-		// a big buffer and dole it out
-		return AllocTrack(amount, filename, line);
-	}
-
-	void GetMemoryUsage(size_t* usage)
-	{
-		*usage = g_requestedMemoryUsed;
-	}
-
-	void DumpReport(const char* filename)
-	{
-		FILE* fp;
-#ifdef _WIN32
-		fopen_s(&fp, filename, "w");
-#else
-		fp = fopen(filename, "w");
-#endif
-
-		fprintf(fp, "[\n");
-
-		auto page = g_firstPage;
-		while (page != nullptr)
-		{
-			for (uint32 i = 0; i < page->NumAllocations; i++)
-			{
-				fprintf(fp, "\t{\n");
-
-				fprintf(fp, "\t\t\"requestedSize\": %u,\n", (uint32)page->Allocations[i].RequestedSize);
-
-				if (page->Allocations[i].Info == nullptr)
-				{
-					fprintf(fp, "\t\t\"freed\": true,\n");
-					fprintf(fp, "\t\t\"filename\": null,\n");
-					fprintf(fp, "\t\t\"line\": null\n");
-				}
-				else
-				{
-#ifdef _WIN32
-					// Windows puts \ in paths, which aren't legal in json without escaping them, so replace them
-					for (char* c = page->Allocations[i].Info->Filename; *c != 0; c++)
-						if (*c == '\\') *c = '/';
-#endif
-
-					fprintf(fp, "\t\t\"freed\": false,\n");
-					fprintf(fp, "\t\t\"filename\": \"%s\",\n", page->Allocations[i].Info->Filename);
-					fprintf(fp, "\t\t\"line\": %u\n", page->Allocations[i].Info->Line);
-				}
-
-				if (i < page->NumAllocations - 1)
-					fprintf(fp, "\t},\n");
-				else
-					fprintf(fp, "\t}\n");
-			}
-
-			page = page->Next;
-		}
-
-
-		fprintf(fp, "]\n");
-
-		fclose(fp);
-	}
+#include "MemoryManager.h"
+#include <memory>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include "CleanWindows.h"
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#include <execinfo.h>
+#endif
+
+// full tracking (who allocated what, guard bytes, leak reports) is for debug and QA builds
+#ifndef GAME_ENABLE_MEMORY_TRACKING
+#define MEM_BASIC_ALLOC
+#endif
+
+// the slab allocator sits behind the basic allocator. Turn it off to get plain malloc() back (for valgrind and friends).
+#ifndef GAME_DISABLE_SLAB_ALLOC
+#define MEM_SLAB_ALLOC
+#endif
+
+std::atomic<uint32> g_heapAllocations = { 0 };
+
+namespace MemoryManagerInternal
+{
+	// Every tracked allocation gets a record. Records go in pages that only get appended to by the thread
+	// that owns them, so tracking an allocation never takes a lock. The pages only get walked when
+	// somebody asks for a report.
+	struct AllocRecord
+	{
+		const char* Filename; // always a __FILE__, so there's no need to copy it
+		uint32 Line;
+		std::atomic<uint8> Freed;
+		MemoryTag Tag;
+		size_t RequestedSize;
+	};
+
+	struct AllocRecordPage
+	{
+		static const uint32 MaxRecords = 1000;
+		AllocRecord Records[MaxRecords];
+		std::atomic<uint32> NumRecords;
+		std::atomic<AllocRecordPage*> Next;
+	};
+
+	// One of these per thread. When a thread exits the next new thread takes over its tracker.
+	struct AllocTracker
+	{
+		AllocRecordPage* FirstPage;
+		AllocRecordPage* CurrentPage;
+
+		// only the owner writes these, so a thread that frees memory another thread allocated goes negative
+		std::atomic<int64> RequestedSize;
+		std::atomic<int64> ActualSize;
+
+		std::atomic<bool> InUse;
+		AllocTracker* Next;
+	};
+
+	// this goes right in front of the guard bytes in front of the memory
+	struct AllocHeader
+	{
+		AllocRecord* Record;
+		size_t RequestedSize;
+		size_t TotalSize;
+		size_t Offset; // from the start of the real allocation to the memory that got handed out
+	};
+
+	static const size_t GuardSize = 16;
+	static const uint8 GuardValue = 0xb0;
+
+	std::atomic<AllocTracker*> g_trackers;
+
+	struct AllocTrackerOwner
+	{
+		AllocTracker* Tracker;
+
+		~AllocTrackerOwner()
+		{
+			if (Tracker != nullptr)
+				Tracker->InUse.store(false, std::memory_order_release);
+		}
+	};
+
+	thread_local AllocTrackerOwner t_tracker;
+
+	// Unlike the trackers these are shared by every thread, since that's the only way to get a real peak.
+	// Budgets get checked as memory is allocated, so going over and coming back within a frame still counts.
+	struct alignas(64) TagCounters
+	{
+		std::atomic<int64> Current;
+		std::atomic<int64> Peak;
+		std::atomic<int32> Count;
+		std::atomic<uint32> TotalAllocations;
+
+		std::atomic<size_t> SoftBudget;
+		std::atomic<size_t> HardBudget;
+		std::atomic<uint32> SoftBudgetCrossings;
+		std::atomic<uint32> HardBudgetCrossings;
+	};
+
+	TagCounters g_tagCounters[(uint32)MemoryTag::LAST];
+	thread_local MemoryTag t_memoryTag = MemoryTag::General;
+
+	struct FrameArena
+	{
+		uint8* Memory;
+		size_t Size;
+		std::atomic<size_t> Used; // can end up past Size, in which case the rest went to the heap
+		void* Overflow;           // heap blocks for allocations that didn't fit, freed when the arena is reset
+	};
+
+	struct alignas(16) FrameOverflowBlock
+	{
+		FrameOverflowBlock* Next;
+	};
+
+	static const size_t DefaultFrameArenaSize = 1024 * 1024;
+	FrameArena g_frameArenas[2];
+	std::atomic<uint32> g_currentFrameArena;
+	std::atomic_flag g_frameOverflowLock = ATOMIC_FLAG_INIT;
+	std::atomic<uint32> g_frameOverflows;
+	uint32 g_frameStartHeapAllocations;
+	MemoryFrameStats g_lastFrameStats;
+
+	struct ScratchBlock
+	{
+		ScratchBlock* Prev;
+		ScratchBlock* Next;
+		size_t Start; // where this block starts in the thread's scratch space, so marks can cross blocks
+		size_t Size;
+		size_t Used;
+	};
+
+	struct ScratchSpace
+	{
+		ScratchBlock* First;
+		ScratchBlock* Current;
+
+		~ScratchSpace()
+		{
+			while (First != nullptr)
+			{
+				auto next = First->Next;
+				free(First);
+				First = next;
+			}
+		}
+	};
+
+	static const size_t ScratchBlockSize = 256 * 1024;
+	thread_local ScratchSpace t_scratch;
+
+	// AllocAndKeep() memory comes from one big reservation that only ever grows, so everything that lives
+	// as long as the game does ends up packed together (on huge pages, where the OS lets us). Pages only
+	// get committed as they're used.
+	static const size_t KeepRegionSize = 64 * 1024 * 1024;
+	static const size_t KeepAlignment = 64; // so managers packed next to each other don't share cache lines
+	uint8* g_keepRegion;
+	size_t g_keepUsed;
+	size_t g_keepCommitted;
+	std::atomic_flag g_keepLock = ATOMIC_FLAG_INIT;
+
+	// Heap calls made by a thread that's being audited. There should be hardly any of these, so they
+	// just get searched in order (which also keeps them in the order they were first seen).
+	static const uint32 MaxAuditEntries = 256;
+	MemoryAuditEntry g_auditEntries[MaxAuditEntries];
+	uint32 g_numAuditEntries;
+	std::atomic<uint32> g_auditHits;
+	std::atomic_flag g_auditLock = ATOMIC_FLAG_INIT;
+	thread_local MemoryAuditMode t_auditMode = MemoryAuditMode::Off;
+	thread_local uint32 t_auditPauses;
+
+	enum class AuditCall
+	{
+		Alloc,
+		Realloc,
+		Free
+	};
+
+	inline uint8* alignPointer(uint8* p, size_t alignment)
+	{
+		return (uint8*)(((uintptr_t)p + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	}
+
+#ifdef MEM_SLAB_ALLOC
+	// Small allocations come out of size classes carved from 64k spans, with a free list per thread in
+	// front of a shared one for each class. Anything bigger (or more aligned) gets its own mapping.
+	// Spans and mappings are all SpanSize aligned and start with a SlabSpan, so freeing only needs the pointer.
+	// Each span only holds one tag, which is how frees get counted against the right tag without full tracking.
+	static const size_t SpanSize = 64 * 1024;
+	static const size_t SpanHeaderSize = 64;
+	static const size_t MaxSlabAlignment = 64;
+	static const uint32 NumSizeClasses = 16;
+	static const uint32 NumSlabTags = (uint32)MemoryTag::LAST;
+	static constexpr uint32 SizeClasses[NumSizeClasses] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096 };
+	static const uint32 LargeSizeClass = 0xffffffff;
+	static const uint32 MaxThreadCacheSize = 64 * 1024; // bytes per class and tag before a thread gives some back
+
+	// freed mappings up to 1MB get kept around (sizes rounded up to a power of 2) so loading doesn't turn into syscalls
+	static const uint32 NumMappingBuckets = 8;
+	static const size_t MinBucketMappingSize = 8 * 1024;
+	static const size_t MaxCachedMappingBytes = 16 * 1024 * 1024;
+
+	struct SlabSpan
+	{
+		uint32 SizeClass;
+		uint32 Offset;     // large allocations only, from the start of the mapping to the memory
+		size_t MappedSize; // large allocations only
+		MemoryTag Tag;
+	};
+	static_assert(sizeof(SlabSpan) <= SpanHeaderSize, "SlabSpan is too big");
+
+	inline SlabSpan* slabSpan(void* memory)
+	{
+		return (SlabSpan*)((uintptr_t)memory & ~(uintptr_t)(SpanSize - 1));
+	}
+
+	struct SlabBlock
+	{
+		SlabBlock* Next;
+	};
+
+	struct SlabClass
+	{
+		std::atomic_flag Lock;
+		SlabBlock* FreeList;
+		uint8* Carve; // the part of the newest span that's never been handed out
+		uint8* CarveEnd;
+	};
+
+	SlabClass g_slabClasses[NumSlabTags][NumSizeClasses];
+
+	struct SlabMappingCache
+	{
+		std::atomic_flag Lock;
+		SlabSpan* Buckets[NumMappingBuckets]; // linked through the first pointer after the SlabSpan
+		size_t CachedBytes;
+	};
+
+	SlabMappingCache g_mappingCache;
+
+	void slabReturnBlocks(uint32 tag, uint32 sizeClass, SlabBlock* first, SlabBlock* last)
+	{
+		SlabClass* c = &g_slabClasses[tag][sizeClass];
+		while (c->Lock.test_and_set(std::memory_order_acquire));
+		last->Next = c->FreeList;
+		c->FreeList = first;
+		c->Lock.clear(std::memory_order_release);
+	}
+
+	struct SlabThreadCache
+	{
+		SlabBlock* FreeList[NumSlabTags][NumSizeClasses];
+		uint32 NumFree[NumSlabTags][NumSizeClasses];
+
+		~SlabThreadCache()
+		{
+			// the thread is going away, so let everybody else have its blocks
+			for (uint32 t = 0; t < NumSlabTags; t++)
+			{
+				for (uint32 i = 0; i < NumSizeClasses; i++)
+				{
+					if (FreeList[t][i] == nullptr)
+						continue;
+
+					SlabBlock* last = FreeList[t][i];
+					while (last->Next != nullptr)
+						last = last->Next;
+					slabReturnBlocks(t, i, FreeList[t][i], last);
+
+					FreeList[t][i] = nullptr;
+					NumFree[t][i] = 0;
+				}
+			}
+		}
+	};
+
+	thread_local SlabThreadCache t_slabCache;
+
+	size_t getPageSize()
+	{
+#ifdef _WIN32
+		return 4096;
+#else
+		static size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		return pageSize;
+#endif
+	}
+
+	// returns SpanSize aligned memory straight from the OS
+	void* mapMemory(size_t size)
+	{
+#ifdef _WIN32
+		// VirtualAlloc() always returns memory aligned to the 64k allocation granularity
+		static_assert(SpanSize == 64 * 1024, "SpanSize has to match the VirtualAlloc() granularity");
+		return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+		// map extra so there's room to line it up, then give back whatever's left over
+		uint8* memory = (uint8*)mmap(nullptr, size + SpanSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED)
+			return nullptr;
+
+		uint8* aligned = alignPointer(memory, SpanSize);
+		if (aligned > memory)
+			munmap(memory, aligned - memory);
+		if (memory + size + SpanSize > aligned + size)
+			munmap(aligned + size, (memory + size + SpanSize) - (aligned + size));
+
+		return aligned;
+#endif
+	}
+
+	void unmapMemory(void* memory, size_t size)
+	{
+#ifdef _WIN32
+		VirtualFree(memory, 0, MEM_RELEASE);
+#else
+		munmap(memory, size);
+#endif
+	}
+
+	// size class for each multiple of 16 bytes, for the usual case where the alignment doesn't matter
+	struct SlabSizeClassTable
+	{
+		uint8 Classes[4096 / 16 + 1];
+
+		constexpr SlabSizeClassTable() : Classes()
+		{
+			uint32 sizeClass = 0;
+			for (uint32 i = 0; i <= 4096 / 16; i++)
+			{
+				while (SizeClasses[sizeClass] < i * 16)
+					sizeClass++;
+				Classes[i] = (uint8)sizeClass;
+			}
+		}
+	};
+	static constexpr SlabSizeClassTable g_slabSizeClassTable;
+
+	int32 slabSizeClass(size_t amount, size_t alignment)
+	{
+		if (alignment <= 16 && amount <= 4096)
+			return g_slabSizeClassTable.Classes[(amount + 15) / 16];
+		if (alignment > MaxSlabAlignment)
+			return -1;
+
+		for (uint32 i = 0; i < NumSizeClasses; i++)
+		{
+			// every block in a span lines up to its class size, as long as the class size is a multiple of the alignment
+			if (SizeClasses[i] >= amount && SizeClasses[i] % alignment == 0)
+				return (int32)i;
+		}
+
+		return -1;
+	}
+
+	void* slabAllocLarge(size_t amount, size_t alignment, MemoryTag tag)
+	{
+		size_t offset = alignment > SpanHeaderSize ? alignment : SpanHeaderSize;
+		if (offset >= SpanSize)
+			return nullptr;
+
+		size_t pageSize = getPageSize();
+		size_t mappedSize = (offset + amount + pageSize - 1) & ~(pageSize - 1);
+
+		int32 bucket = -1;
+		for (uint32 i = 0; i < NumMappingBuckets; i++)
+		{
+			if ((MinBucketMappingSize << i) >= mappedSize)
+			{
+				bucket = (int32)i;
+				mappedSize = MinBucketMappingSize << i;
+				break;
+			}
+		}
+
+		SlabSpan* span = nullptr;
+		if (bucket >= 0)
+		{
+			while (g_mappingCache.Lock.test_and_set(std::memory_order_acquire));
+			span = g_mappingCache.Buckets[bucket];
+			if (span != nullptr)
+			{
+				g_mappingCache.Buckets[bucket] = *(SlabSpan**)(span + 1);
+				g_mappingCache.CachedBytes -= mappedSize;
+			}
+			g_mappingCache.Lock.clear(std::memory_order_release);
+		}
+
+		if (span == nullptr)
+			span = (SlabSpan*)mapMemory(mappedSize);
+		if (span == nullptr)
+			return nullptr;
+
+		span->SizeClass = LargeSizeClass;
+		span->Offset = (uint32)offset;
+		span->MappedSize = mappedSize;
+		span->Tag = tag;
+
+		return (uint8*)span + offset;
+	}
+
+	bool slabRefill(uint32 tag, uint32 sizeClass, SlabThreadCache* cache)
+	{
+		// grab enough to fill up half the thread cache
+		const uint32 blockSize = SizeClasses[sizeClass];
+		uint32 count = MaxThreadCacheSize / 2 / blockSize;
+		if (count == 0) count = 1;
+
+		SlabClass* c = &g_slabClasses[tag][sizeClass];
+		while (c->Lock.test_and_set(std::memory_order_acquire));
+
+		uint32 numTaken = 0;
+		while (numTaken < count)
+		{
+			SlabBlock* block = c->FreeList;
+			if (block != nullptr)
+			{
+				c->FreeList = block->Next;
+			}
+			else
+			{
+				if (c->Carve + blockSize > c->CarveEnd)
+				{
+					SlabSpan* span = (SlabSpan*)mapMemory(SpanSize);
+					if (span == nullptr)
+						break;
+
+					span->SizeClass = sizeClass;
+					span->Offset = 0;
+					span->MappedSize = SpanSize;
+					span->Tag = (MemoryTag)tag;
+
+					c->Carve = (uint8*)span + SpanHeaderSize;
+					c->CarveEnd = (uint8*)span + SpanSize;
+				}
+
+				block = (SlabBlock*)c->Carve;
+				c->Carve += blockSize;
+			}
+
+			block->Next = cache->FreeList[tag][sizeClass];
+			cache->FreeList[tag][sizeClass] = block;
+			numTaken++;
+		}
+
+		c->Lock.clear(std::memory_order_release);
+
+		cache->NumFree[tag][sizeClass] += numTaken;
+		return numTaken > 0;
+	}
+
+	void* slabAlloc(size_t amount, size_t alignment, MemoryTag tag)
+	{
+		if (alignment < 16)
+			alignment = 16;
+
+		int32 sizeClass = slabSizeClass(amount, alignment);
+		if (sizeClass < 0)
+			return slabAllocLarge(amount, alignment, tag);
+
+		uint32 t = (uint32)tag;
+		SlabThreadCache* cache = &t_slabCache;
+		if (cache->FreeList[t][sizeClass] == nullptr && slabRefill(t, sizeClass, cache) == false)
+			return nullptr;
+
+		SlabBlock* block = cache->FreeList[t][sizeClass];
+		cache->FreeList[t][sizeClass] = block->Next;
+		cache->NumFree[t][sizeClass]--;
+
+		return block;
+	}
+
+	void slabFree(void* memory)
+	{
+		if (memory == nullptr)
+			return;
+
+		SlabSpan* span = slabSpan(memory);
+		if (span->SizeClass == LargeSizeClass)
+		{
+			size_t mappedSize = span->MappedSize;
+			for (uint32 i = 0; i < NumMappingBuckets; i++)
+			{
+				if ((MinBucketMappingSize << i) != mappedSize)
+					continue;
+
+				bool cached = false;
+				while (g_mappingCache.Lock.test_and_set(std::memory_order_acquire));
+				if (g_mappingCache.CachedBytes + mappedSize <= MaxCachedMappingBytes)
+				{
+					*(SlabSpan**)(span + 1) = g_mappingCache.Buckets[i];
+					g_mappingCache.Buckets[i] = span;
+					g_mappingCache.CachedBytes += mappedSize;
+					cached = true;
+				}
+				g_mappingCache.Lock.clear(std::memory_order_release);
+
+				if (cached)
+					return;
+				break;
+			}
+
+			unmapMemory(span, mappedSize);
+			return;
+		}
+
+		uint32 sizeClass = span->SizeClass;
+		uint32 tag = (uint32)span->Tag;
+		SlabThreadCache* cache = &t_slabCache;
+
+		SlabBlock* block = (SlabBlock*)memory;
+		block->Next = cache->FreeList[tag][sizeClass];
+		cache->FreeList[tag][sizeClass] = block;
+		cache->NumFree[tag][sizeClass]++;
+
+		// don't let one thread sit on too much, in case it's freeing things another thread allocated
+		if (cache->NumFree[tag][sizeClass] * SizeClasses[sizeClass] > MaxThreadCacheSize)
+		{
+			uint32 count = cache->NumFree[tag][sizeClass] / 2;
+
+			SlabBlock* first = cache->FreeList[tag][sizeClass];
+			SlabBlock* last = first;
+			for (uint32 i = 1; i < count; i++)
+				last = last->Next;
+
+			cache->FreeList[tag][sizeClass] = last->Next;
+			cache->NumFree[tag][sizeClass] -= count;
+			slabReturnBlocks(tag, sizeClass, first, last);
+		}
+	}
+
+	// how much of the block can really be used, which can be more than was asked for
+	size_t slabSize(void* memory)
+	{
+		SlabSpan* span = slabSpan(memory);
+		if (span->SizeClass == LargeSizeClass)
+			return span->MappedSize - span->Offset;
+
+		return SizeClasses[span->SizeClass];
+	}
+
+	void* slabRealloc(void* original, size_t amount)
+	{
+		size_t available = slabSize(original);
+
+		// it still fits, so leave it where it is
+		if (amount <= available)
+			return original;
+
+		// it's still the same memory, so it keeps its tag
+		void* memory = slabAlloc(amount, 16, slabSpan(original)->Tag);
+		if (memory == nullptr)
+			return nullptr;
+
+		memcpy(memory, original, available);
+		slabFree(original);
+
+		return memory;
+	}
+#endif
+
+	void* rawAlloc(size_t amount, MemoryTag tag)
+	{
+#ifdef MEM_SLAB_ALLOC
+		return slabAlloc(amount, 16, tag);
+#else
+		return malloc(amount);
+#endif
+	}
+
+	void rawFree(void* memory)
+	{
+#ifdef MEM_SLAB_ALLOC
+		slabFree(memory);
+#else
+		free(memory);
+#endif
+	}
+
+	AllocTracker* getTracker()
+	{
+		AllocTracker* tracker = t_tracker.Tracker;
+		if (tracker != nullptr)
+			return tracker;
+
+		// take over one from a thread that's gone, or make a new one
+		for (tracker = g_trackers.load(std::memory_order_acquire); tracker != nullptr; tracker = tracker->Next)
+		{
+			bool inUse = false;
+			if (tracker->InUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+				break;
+		}
+
+		if (tracker == nullptr)
+		{
+			auto page = (AllocRecordPage*)malloc(sizeof(AllocRecordPage));
+			page->NumRecords.store(0, std::memory_order_relaxed);
+			page->Next.store(nullptr, std::memory_order_relaxed);
+
+			tracker = (AllocTracker*)malloc(sizeof(AllocTracker));
+			tracker->FirstPage = tracker->CurrentPage = page;
+			tracker->RequestedSize.store(0, std::memory_order_relaxed);
+			tracker->ActualSize.store(0, std::memory_order_relaxed);
+			tracker->InUse.store(true, std::memory_order_relaxed);
+
+			tracker->Next = g_trackers.load(std::memory_order_relaxed);
+			while (g_trackers.compare_exchange_weak(tracker->Next, tracker, std::memory_order_release, std::memory_order_relaxed) == false);
+		}
+
+		t_tracker.Tracker = tracker;
+		return tracker;
+	}
+
+	inline void addToTotal(std::atomic<int64>* total, int64 amount)
+	{
+		// there's only ever one writer, so this doesn't need to be a locked add
+		total->store(total->load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	inline void checkBudget(std::atomic<size_t>* budget, std::atomic<uint32>* crossings, int64 before, int64 after)
+	{
+		int64 limit = (int64)budget->load(std::memory_order_relaxed);
+		if (limit != 0 && before <= limit && after > limit)
+			crossings->fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// count is how many allocations are live now that weren't before (or the other way, if it's negative)
+	void addToTag(MemoryTag tag, int64 amount, int32 count, uint32 allocations)
+	{
+		TagCounters* counters = &g_tagCounters[(uint32)tag];
+		int64 current = counters->Current.fetch_add(amount, std::memory_order_relaxed) + amount;
+
+		counters->Count.fetch_add(count, std::memory_order_relaxed);
+		if (allocations != 0)
+			counters->TotalAllocations.fetch_add(allocations, std::memory_order_relaxed);
+
+		if (amount <= 0)
+			return;
+
+		int64 peak = counters->Peak.load(std::memory_order_relaxed);
+		while (current > peak && counters->Peak.compare_exchange_weak(peak, current, std::memory_order_relaxed) == false);
+
+		checkBudget(&counters->SoftBudget, &counters->SoftBudgetCrossings, current - amount, current);
+		checkBudget(&counters->HardBudget, &counters->HardBudgetCrossings, current - amount, current);
+	}
+
+#ifdef MEM_BASIC_ALLOC
+#ifndef MEM_SLAB_ALLOC
+	// without slab spans there's nowhere else to keep the tag, so it goes in front of the memory
+	struct alignas(16) BasicHeader
+	{
+		size_t Size;
+		MemoryTag Tag;
+	};
+#endif
+
+	// Without full tracking the tags still get counted, just by the size the allocator really
+	// handed out (so slab allocations are rounded up to their size class or page). Each thread keeps
+	// its own totals and only adds them to the shared ones once they've moved far enough, since
+	// a locked add on every allocation would cost more than the allocation does.
+	static const int64 TagFlushBytes = 64 * 1024;
+	static const int32 TagFlushCount = 64;
+
+	struct TagDeltas
+	{
+		int64 Amount[(uint32)MemoryTag::LAST];
+		int32 Count[(uint32)MemoryTag::LAST];
+		uint32 Allocations[(uint32)MemoryTag::LAST];
+
+		void Flush(uint32 tag)
+		{
+			addToTag((MemoryTag)tag, Amount[tag], Count[tag], Allocations[tag]);
+			Amount[tag] = 0;
+			Count[tag] = 0;
+			Allocations[tag] = 0;
+		}
+
+		void FlushAll()
+		{
+			for (uint32 i = 0; i < (uint32)MemoryTag::LAST; i++)
+			{
+				if (Amount[i] != 0 || Count[i] != 0 || Allocations[i] != 0)
+					Flush(i);
+			}
+		}
+
+		~TagDeltas() { FlushAll(); }
+	};
+
+	thread_local TagDeltas t_tagDeltas;
+
+	inline void countTag(MemoryTag tag, int64 amount)
+	{
+		TagDeltas* deltas = &t_tagDeltas;
+		uint32 t = (uint32)tag;
+
+		deltas->Amount[t] += amount;
+		if (amount > 0)
+		{
+			deltas->Count[t]++;
+			deltas->Allocations[t]++;
+		}
+		else
+		{
+			deltas->Count[t]--;
+		}
+
+		if (deltas->Amount[t] >= TagFlushBytes || deltas->Amount[t] <= -TagFlushBytes ||
+			deltas->Count[t] >= TagFlushCount || deltas->Count[t] <= -TagFlushCount || deltas->Allocations[t] >= (uint32)TagFlushCount)
+			deltas->Flush(t);
+	}
+
+	void* basicAlloc(size_t amount, size_t alignment, MemoryTag tag)
+	{
+#ifdef MEM_SLAB_ALLOC
+		void* memory = slabAlloc(amount, alignment, tag);
+		if (memory != nullptr)
+			countTag(tag, (int64)slabSize(memory));
+
+		return memory;
+#else
+		auto header = (BasicHeader*)malloc(sizeof(BasicHeader) + amount);
+		if (header == nullptr)
+			return nullptr;
+
+		header->Size = amount;
+		header->Tag = tag;
+		countTag(tag, (int64)amount);
+
+		return header + 1;
+#endif
+	}
+
+	void* basicRealloc(void* original, size_t amount)
+	{
+#ifdef MEM_SLAB_ALLOC
+		MemoryTag tag = slabSpan(original)->Tag;
+		size_t originalSize = slabSize(original);
+
+		void* memory = slabRealloc(original, amount);
+		if (memory != nullptr && memory != original)
+		{
+			countTag(tag, (int64)slabSize(memory));
+			countTag(tag, -(int64)originalSize);
+		}
+
+		return memory;
+#else
+		auto header = (BasicHeader*)original - 1;
+		MemoryTag tag = header->Tag;
+		size_t originalSize = header->Size;
+
+		header = (BasicHeader*)realloc(header, sizeof(BasicHeader) + amount);
+		if (header == nullptr)
+			return nullptr;
+
+		header->Size = amount;
+		countTag(tag, (int64)amount);
+		countTag(tag, -(int64)originalSize);
+
+		return header + 1;
+#endif
+	}
+
+	void basicFree(void* memory)
+	{
+#ifdef MEM_SLAB_ALLOC
+		countTag(slabSpan(memory)->Tag, -(int64)slabSize(memory));
+		slabFree(memory);
+#else
+		auto header = (BasicHeader*)memory - 1;
+		countTag(header->Tag, -(int64)header->Size);
+		free(header);
+#endif
+	}
+#endif
+
+	AllocRecord* newRecord(AllocTracker* tracker, const char* filename, int line, size_t amount, MemoryTag tag)
+	{
+		AllocRecordPage* page = tracker->CurrentPage;
+		uint32 numRecords = page->NumRecords.load(std::memory_order_relaxed);
+		if (numRecords == AllocRecordPage::MaxRecords)
+		{
+			auto newPage = (AllocRecordPage*)malloc(sizeof(AllocRecordPage));
+			newPage->NumRecords.store(0, std::memory_order_relaxed);
+			newPage->Next.store(nullptr, std::memory_order_relaxed);
+
+			page->Next.store(newPage, std::memory_order_release);
+			tracker->CurrentPage = page = newPage;
+			numRecords = 0;
+		}
+
+		AllocRecord* record = &page->Records[numRecords];
+		record->Filename = filename;
+		record->Line = (uint32)line;
+		record->Freed.store(0, std::memory_order_relaxed);
+		record->Tag = tag;
+		record->RequestedSize = amount;
+
+		// now the reports can see it
+		page->NumRecords.store(numRecords + 1, std::memory_order_release);
+
+		return record;
+	}
+
+	AllocHeader* checkGuards(void* memory)
+	{
+		AllocHeader* header = (AllocHeader*)((uint8*)memory - GuardSize) - 1;
+
+		// TODO: is there a better way to cause an abort and still possibly get an error message? Almost definitely.
+		for (uint8* mem = (uint8*)memory - GuardSize; mem < memory; mem++)
+			if (*mem != GuardValue)
+				throw "Memory is corrupt";
+		for (uint8* mem = (uint8*)memory + header->RequestedSize; mem < (uint8*)memory + header->RequestedSize + GuardSize; mem++)
+			if (*mem != GuardValue)
+				throw "Memory is corrupt";
+
+		return header;
+	}
+
+	void* trackedAlloc(size_t amount, size_t alignment, const char* filename, int line, MemoryTag tag)
+	{
+		AllocTracker* tracker = getTracker();
+
+		if (alignment < 16)
+			alignment = 16;
+
+		// room for the header and guards in front, plus whatever it takes to line up the memory
+		size_t totalSize = sizeof(AllocHeader) + GuardSize + (alignment - 16) + amount + GuardSize;
+		uint8* real = (uint8*)rawAlloc(totalSize, tag);
+		if (real == nullptr)
+			return nullptr;
+
+		uint8* memory = alignPointer(real + sizeof(AllocHeader) + GuardSize, alignment);
+		AllocHeader* header = (AllocHeader*)(memory - GuardSize) - 1;
+		header->RequestedSize = amount;
+		header->TotalSize = totalSize;
+		header->Offset = memory - real;
+		header->Record = newRecord(tracker, filename, line, amount, tag);
+
+		memset(memory - GuardSize, GuardValue, GuardSize);
+		memset(memory + amount, GuardValue, GuardSize);
+
+		addToTotal(&tracker->RequestedSize, (int64)amount);
+		addToTotal(&tracker->ActualSize, (int64)totalSize);
+		addToTag(tag, (int64)amount, 1, 1);
+
+		return memory;
+	}
+
+	void trackedFree(void* memory)
+	{
+		AllocHeader* header = checkGuards(memory);
+		AllocTracker* tracker = getTracker();
+
+		addToTotal(&tracker->RequestedSize, -(int64)header->RequestedSize);
+		addToTotal(&tracker->ActualSize, -(int64)header->TotalSize);
+		addToTag(header->Record->Tag, -(int64)header->RequestedSize, -1, 0);
+
+		header->Record->Freed.store(1, std::memory_order_relaxed);
+
+		rawFree((uint8*)memory - header->Offset);
+	}
+
+	void writeJsonString(FILE* fp, const char* text)
+	{
+		fputc('"', fp);
+		for (const char* c = text; *c != 0; c++)
+		{
+			// Windows puts \ in paths, which aren't legal in json without escaping them, so replace them
+			if (*c == '\\')
+				fputc('/', fp);
+			else if (*c == '"')
+				fputs("\\\"", fp);
+			else
+				fputc(*c, fp);
+		}
+		fputc('"', fp);
+	}
+
+	void printBacktrace()
+	{
+#ifdef _WIN32
+		void* frames[32];
+		USHORT numFrames = CaptureStackBackTrace(2, 32, frames, nullptr);
+		for (USHORT i = 0; i < numFrames; i++)
+			fprintf(stderr, "\t%p\n", frames[i]);
+#else
+		void* frames[32];
+		int numFrames = backtrace(frames, 32);
+		backtrace_symbols_fd(frames, numFrames, 2);
+#endif
+	}
+
+	void audit(AuditCall call, const char* filename, int line)
+	{
+		if (t_auditPauses > 0)
+			return;
+
+		if (t_auditMode == MemoryAuditMode::Abort)
+		{
+			const char* names[] = { "Alloc", "Realloc", "Free" };
+			fprintf(stderr, "%s() at %s:%d during steady state\n", names[(int)call], filename != nullptr ? filename : "(unknown)", line);
+			printBacktrace();
+			fflush(stderr);
+			abort();
+		}
+
+		g_auditHits.fetch_add(1, std::memory_order_relaxed);
+
+		while (g_auditLock.test_and_set(std::memory_order_acquire));
+
+		MemoryAuditEntry* entry = nullptr;
+		for (uint32 i = 0; i < g_numAuditEntries; i++)
+		{
+			if (g_auditEntries[i].Filename == filename && g_auditEntries[i].Line == (uint32)line)
+			{
+				entry = &g_auditEntries[i];
+				break;
+			}
+		}
+
+		// once it's full the rest only show up in the total
+		if (entry == nullptr && g_numAuditEntries < MaxAuditEntries)
+		{
+			entry = &g_auditEntries[g_numAuditEntries++];
+			entry->Filename = filename;
+			entry->Line = (uint32)line;
+			entry->Allocs = entry->Reallocs = entry->Frees = 0;
+		}
+
+		if (entry != nullptr)
+		{
+			if (call == AuditCall::Alloc)
+				entry->Allocs++;
+			else if (call == AuditCall::Realloc)
+				entry->Reallocs++;
+			else
+				entry->Frees++;
+		}
+
+		g_auditLock.clear(std::memory_order_release);
+	}
+
+	void reserveKeepRegion()
+	{
+#ifdef _WIN32
+		// large pages need SeLockMemoryPrivilege, which nobody's going to have, so these are regular pages
+		g_keepRegion = (uint8*)VirtualAlloc(nullptr, KeepRegionSize, MEM_RESERVE, PAGE_READWRITE);
+		g_keepCommitted = 0;
+#else
+		// line it up on a 2MB boundary so it can be backed by transparent huge pages
+		const size_t hugePageSize = 2 * 1024 * 1024;
+		uint8* memory = (uint8*)mmap(nullptr, KeepRegionSize + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (memory == MAP_FAILED)
+		{
+			g_keepRegion = nullptr;
+			return;
+		}
+
+		g_keepRegion = alignPointer(memory, hugePageSize);
+		if (g_keepRegion > memory)
+			munmap(memory, g_keepRegion - memory);
+		if (g_keepRegion + KeepRegionSize < memory + KeepRegionSize + hugePageSize)
+			munmap(g_keepRegion + KeepRegionSize, (memory + KeepRegionSize + hugePageSize) - (g_keepRegion + KeepRegionSize));
+
+#ifdef MADV_HUGEPAGE
+		madvise(g_keepRegion, KeepRegionSize, MADV_HUGEPAGE);
+#endif
+		// mmap() commits pages as they get touched
+		g_keepCommitted = KeepRegionSize;
+#endif
+		g_keepUsed = 0;
+	}
+
+	inline bool isKeepMemory(void* memory)
+	{
+		return (uint8*)memory >= g_keepRegion && (uint8*)memory < g_keepRegion + KeepRegionSize;
+	}
+
+	void Initialize()
+	{
+		reserveKeepRegion();
+
+		for (uint32 i = 0; i < 2; i++)
+		{
+			g_frameArenas[i].Memory = (uint8*)malloc(DefaultFrameArenaSize);
+			g_frameArenas[i].Size = DefaultFrameArenaSize;
+			g_frameArenas[i].Used = 0;
+			g_frameArenas[i].Overflow = nullptr;
+		}
+		g_currentFrameArena = 0;
+	}
+
+	void Shutdown()
+	{
+		// the tracking records stay around, since threads still let go of their trackers as they exit.
+		// So does the AllocAndKeep() region, since that's the whole point of it.
+
+		for (uint32 i = 0; i < 2; i++)
+		{
+			auto block = (FrameOverflowBlock*)g_frameArenas[i].Overflow;
+			while (block != nullptr)
+			{
+				auto next = block->Next;
+				free(block);
+				block = next;
+			}
+
+			free(g_frameArenas[i].Memory);
+			g_frameArenas[i].Memory = nullptr;
+		}
+
+#ifdef MEM_SLAB_ALLOC
+		// the slab spans themselves stay mapped, since something could still be holding on to a block
+		for (uint32 i = 0; i < NumMappingBuckets; i++)
+		{
+			SlabSpan* span = g_mappingCache.Buckets[i];
+			while (span != nullptr)
+			{
+				SlabSpan* next = *(SlabSpan**)(span + 1);
+				unmapMemory(span, span->MappedSize);
+				span = next;
+			}
+			g_mappingCache.Buckets[i] = nullptr;
+		}
+		g_mappingCache.CachedBytes = 0;
+#endif
+	}
+
+	void SetDefaults(MemoryManager* manager)
+	{
+		manager->Alloc = MemoryManagerInternal::Alloc;
+		manager->AllocTrack = MemoryManagerInternal::AllocTrack;
+		manager->AlignedAlloc = MemoryManagerInternal::AlignedAlloc;
+		manager->AlignedAllocTrack = MemoryManagerInternal::AlignedAllocTrack;
+		manager->Realloc = MemoryManagerInternal::Realloc;
+		manager->ReallocTrack = MemoryManagerInternal::ReallocTrack;
+		manager->Free = MemoryManagerInternal::Free;
+		manager->FreeTrack = MemoryManagerInternal::FreeTrack;
+		manager->AllocAndKeep = MemoryManagerInternal::AllocAndKeep;
+		manager->FrameAlloc = MemoryManagerInternal::FrameAlloc;
+		manager->NextFrame = MemoryManagerInternal::NextFrame;
+		manager->GetFrameStats = MemoryManagerInternal::GetFrameStats;
+		manager->ScratchAlloc = MemoryManagerInternal::ScratchAlloc;
+		manager->ScratchMark = MemoryManagerInternal::ScratchMark;
+		manager->ScratchRelease = MemoryManagerInternal::ScratchRelease;
+		manager->SetTag = MemoryManagerInternal::SetTag;
+		manager->SetBudget = MemoryManagerInternal::SetBudget;
+		manager->GetStats = MemoryManagerInternal::GetStats;
+		manager->DumpReport = MemoryManagerInternal::DumpReport;
+		manager->SetAuditMode = MemoryManagerInternal::SetAuditMode;
+		manager->PauseAudit = MemoryManagerInternal::PauseAudit;
+		manager->GetAuditResults = MemoryManagerInternal::GetAuditResults;
+		manager->ResetAudit = MemoryManagerInternal::ResetAudit;
+	}
+
+	void* Alloc(size_t amount)
+	{
+		return AllocTrack(amount, nullptr, 0);
+	}
+	
+	void* AlignedAlloc(size_t amount, size_t alignment)
+	{
+		return AlignedAllocTrack(amount, alignment, nullptr, 0);
+	}
+
+	void* AllocTrack(size_t amount, const char* filename, int line)
+	{
+		size_t alignment;
+		if (amount <= 4)
+			alignment = alignof(float);
+		else if (amount <= 8)
+			alignment = alignof(double);
+		else
+			alignment = 16;
+
+		return AlignedAllocTrack(amount, alignment, filename, line);
+	}
+
+	void* AlignedAllocTrack(size_t amount, size_t alignment, const char* filename, int line)
+	{
+		if (t_auditMode != MemoryAuditMode::Off)
+			audit(AuditCall::Alloc, filename, line);
+
+		g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef MEM_BASIC_ALLOC
+		return basicAlloc(amount, alignment, t_memoryTag);
+#else
+		return trackedAlloc(amount, alignment, filename, line, t_memoryTag);
+#endif
+	}
+
+	void* Realloc(void* original, size_t amount)
+	{
+		return ReallocTrack(original, amount, nullptr, 0);
+	}
+
+	void* ReallocTrack(void* original, size_t amount, const char* filename, int line)
+	{
+		if (original == nullptr)
+			return AllocTrack(amount, filename, line);
+
+		if (t_auditMode != MemoryAuditMode::Off)
+			audit(AuditCall::Realloc, filename, line);
+
+		g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef MEM_BASIC_ALLOC
+		return basicRealloc(original, amount);
+#else
+		AllocHeader* header = checkGuards(original);
+
+		// it's still the same memory, so it keeps its tag
+		void* memory = trackedAlloc(amount, 16, filename, line, header->Record->Tag);
+		if (memory == nullptr)
+			return nullptr;
+
+		memcpy(memory, original, header->RequestedSize < amount ? header->RequestedSize : amount);
+		trackedFree(original);
+
+		return memory;
+#endif
+	}
+
+	void Free(void* memory)
+	{
+		FreeTrack(memory, nullptr, 0);
+	}
+
+	void FreeTrack(void* memory, const char* filename, int line)
+	{
+		if (memory == nullptr || isKeepMemory(memory))
+			return;
+
+		if (t_auditMode != MemoryAuditMode::Off)
+			audit(AuditCall::Free, filename, line);
+
+#ifdef MEM_BASIC_ALLOC
+		basicFree(memory);
+#else
+		trackedFree(memory);
+#endif
+	}
+
+	void* AllocAndKeep(size_t amount, const char* filename, int line)
+	{
+		// This is for memory that will be allocated and held until the game exits, so it isn't tracked
+		// (and doesn't show up as a leak). Free() ignores it, so shutdown code can still free it like anything else.
+		uint8* memory = nullptr;
+
+		while (g_keepLock.test_and_set(std::memory_order_acquire));
+		if (g_keepRegion != nullptr)
+		{
+			size_t start = (g_keepUsed + KeepAlignment - 1) & ~(KeepAlignment - 1);
+			if (start + amount <= KeepRegionSize)
+			{
+#ifdef _WIN32
+				if (start + amount > g_keepCommitted)
+				{
+					const size_t commitSize = 1024 * 1024;
+					size_t newCommitted = (start + amount + commitSize - 1) & ~(commitSize - 1);
+					if (newCommitted > KeepRegionSize)
+						newCommitted = KeepRegionSize;
+
+					if (VirtualAlloc(g_keepRegion + g_keepCommitted, newCommitted - g_keepCommitted, MEM_COMMIT, PAGE_READWRITE) != nullptr)
+						g_keepCommitted = newCommitted;
+				}
+#endif
+				if (start + amount <= g_keepCommitted)
+				{
+					memory = g_keepRegion + start;
+					g_keepUsed = start + amount;
+				}
+			}
+		}
+		g_keepLock.clear(std::memory_order_release);
+
+		// the region is full (or there isn't one), so it'll just have to be a regular allocation
+		if (memory == nullptr)
+			return AllocTrack(amount, filename, line);
+
+		if (t_auditMode != MemoryAuditMode::Off)
+			audit(AuditCall::Alloc, filename, line);
+
+		return memory;
+	}
+
+	void* FrameAlloc(size_t amount, size_t alignment)
+	{
+		FrameArena* arena = &g_frameArenas[g_currentFrameArena.load(std::memory_order_acquire)];
+
+		// reserve enough to align it no matter where it lands
+		size_t paddedAmount = amount + alignment - 1;
+		size_t offset = arena->Used.fetch_add(paddedAmount, std::memory_order_relaxed);
+		if (offset + paddedAmount <= arena->Size)
+			return alignPointer(arena->Memory + offset, alignment);
+
+		// it doesn't fit, so use the heap this time. The arena grows the next time it gets reset.
+		g_frameOverflows.fetch_add(1, std::memory_order_relaxed);
+		g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		auto block = (FrameOverflowBlock*)malloc(sizeof(FrameOverflowBlock) + paddedAmount);
+		while (g_frameOverflowLock.test_and_set(std::memory_order_acquire));
+		block->Next = (FrameOverflowBlock*)arena->Overflow;
+		arena->Overflow = block;
+		g_frameOverflowLock.clear(std::memory_order_release);
+
+		return alignPointer((uint8*)(block + 1), alignment);
+	}
+
+	void NextFrame()
+	{
+		uint32 current = g_currentFrameArena.load(std::memory_order_relaxed);
+		uint32 heapAllocations = g_heapAllocations.load(std::memory_order_relaxed);
+
+		g_lastFrameStats.Frame++;
+		g_lastFrameStats.HeapAllocations = heapAllocations - g_frameStartHeapAllocations;
+		g_lastFrameStats.FrameArenaOverflows = g_frameOverflows.exchange(0, std::memory_order_relaxed);
+		g_lastFrameStats.FrameArenaUsed = g_frameArenas[current].Used.load(std::memory_order_relaxed);
+		g_lastFrameStats.FrameArenaSize = g_frameArenas[current].Size;
+
+		// the other arena was last used the frame before, so nothing should be holding on to it now
+		FrameArena* arena = &g_frameArenas[current ^ 1];
+
+		auto block = (FrameOverflowBlock*)arena->Overflow;
+		while (block != nullptr)
+		{
+			auto next = block->Next;
+			free(block);
+			block = next;
+		}
+		arena->Overflow = nullptr;
+
+		// grow it to fit everything it was asked for last time, so steady state frames stay out of the heap
+		size_t used = arena->Used.load(std::memory_order_relaxed);
+		if (used > arena->Size)
+		{
+			size_t newSize = arena->Size;
+			while (newSize < used)
+				newSize *= 2;
+
+			free(arena->Memory);
+			arena->Memory = (uint8*)malloc(newSize);
+			arena->Size = newSize;
+		}
+
+		arena->Used.store(0, std::memory_order_relaxed);
+		g_currentFrameArena.store(current ^ 1, std::memory_order_release);
+
+		g_frameStartHeapAllocations = g_heapAllocations.load(std::memory_order_relaxed);
+	}
+
+	void GetFrameStats(MemoryFrameStats* result)
+	{
+		*result = g_lastFrameStats;
+	}
+
+	void* ScratchAlloc(size_t amount, size_t alignment)
+	{
+		ScratchBlock* block = t_scratch.Current;
+		if (block != nullptr)
+		{
+			uint8* start = (uint8*)(block + 1);
+			uint8* memory = alignPointer(start + block->Used, alignment);
+			if (memory + amount <= start + block->Size)
+			{
+				block->Used = (memory + amount) - start;
+				return memory;
+			}
+		}
+
+		// move on to the next block, and make one if it isn't there (or isn't big enough)
+		size_t needed = amount + alignment - 1;
+		ScratchBlock* next = block != nullptr ? block->Next : t_scratch.First;
+		if (next == nullptr || next->Size < needed)
+		{
+			size_t size = needed > ScratchBlockSize ? needed : ScratchBlockSize;
+			g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+			ScratchBlock* newBlock = (ScratchBlock*)malloc(sizeof(ScratchBlock) + size);
+			newBlock->Size = size;
+			newBlock->Prev = block;
+			newBlock->Next = next;
+			if (next != nullptr)
+				next->Prev = newBlock;
+			if (block != nullptr)
+				block->Next = newBlock;
+			else
+				t_scratch.First = newBlock;
+
+			next = newBlock;
+		}
+
+		next->Start = block != nullptr ? block->Start + block->Size : 0;
+		next->Used = 0;
+		t_scratch.Current = next;
+
+		uint8* memory = alignPointer((uint8*)(next + 1), alignment);
+		next->Used = (memory + amount) - (uint8*)(next + 1);
+		return memory;
+	}
+
+	size_t ScratchMark()
+	{
+		ScratchBlock* block = t_scratch.Current;
+		return block != nullptr ? block->Start + block->Used : 0;
+	}
+
+	void ScratchRelease(size_t mark)
+	{
+		// the blocks stick around so the next scope can reuse them
+		ScratchBlock* block = t_scratch.Current;
+		while (block != nullptr && block->Start > mark)
+			block = block->Prev;
+
+		if (block != nullptr)
+			block->Used = mark - block->Start;
+		t_scratch.Current = block;
+	}
+
+	void GetMemoryUsage(size_t* usage)
+	{
+		int64 total = 0;
+		for (AllocTracker* tracker = g_trackers.load(std::memory_order_acquire); tracker != nullptr; tracker = tracker->Next)
+			total += tracker->RequestedSize.load(std::memory_order_relaxed);
+
+		*usage = total > 0 ? (size_t)total : 0;
+	}
+
+	MemoryTag SetTag(MemoryTag tag)
+	{
+		MemoryTag previous = t_memoryTag;
+		t_memoryTag = tag;
+
+		return previous;
+	}
+
+	void SetBudget(MemoryTag tag, size_t softBudget, size_t hardBudget)
+	{
+		TagCounters* counters = &g_tagCounters[(uint32)tag];
+		counters->SoftBudget.store(softBudget, std::memory_order_relaxed);
+		counters->HardBudget.store(hardBudget, std::memory_order_relaxed);
+	}
+
+	void GetStats(MemoryStats* result)
+	{
+#ifdef MEM_BASIC_ALLOC
+		// other threads can still be a little behind
+		t_tagDeltas.FlushAll();
+		result->Tracking = false;
+#else
+		result->Tracking = true;
+#endif
+
+		while (g_keepLock.test_and_set(std::memory_order_acquire));
+		result->KeepUsed = g_keepUsed;
+		g_keepLock.clear(std::memory_order_release);
+		result->KeepSize = g_keepRegion != nullptr ? KeepRegionSize : 0;
+
+		for (uint32 i = 0; i < (uint32)MemoryTag::LAST; i++)
+		{
+			TagCounters* counters = &g_tagCounters[i];
+			MemoryTagStats* stats = &result->Tags[i];
+
+			// a tag can dip below 0 for a moment while another thread is between the free and the allocation
+			int64 current = counters->Current.load(std::memory_order_relaxed);
+			int32 count = counters->Count.load(std::memory_order_relaxed);
+
+			stats->Current = current > 0 ? (size_t)current : 0;
+			stats->Peak = (size_t)counters->Peak.load(std::memory_order_relaxed);
+			stats->Count = count > 0 ? (uint32)count : 0;
+			stats->TotalAllocations = counters->TotalAllocations.load(std::memory_order_relaxed);
+			stats->SoftBudget = counters->SoftBudget.load(std::memory_order_relaxed);
+			stats->HardBudget = counters->HardBudget.load(std::memory_order_relaxed);
+			stats->SoftBudgetCrossings = counters->SoftBudgetCrossings.load(std::memory_order_relaxed);
+			stats->HardBudgetCrossings = counters->HardBudgetCrossings.load(std::memory_order_relaxed);
+		}
+
+		result->AuditHits = g_auditHits.load(std::memory_order_relaxed);
+		while (g_auditLock.test_and_set(std::memory_order_acquire));
+		result->AuditCallsites = g_numAuditEntries;
+		g_auditLock.clear(std::memory_order_release);
+	}
+
+	MemoryAuditMode SetAuditMode(MemoryAuditMode mode)
+	{
+		MemoryAuditMode previous = t_auditMode;
+		t_auditMode = mode;
+
+		return previous;
+	}
+
+	void PauseAudit(bool pause)
+	{
+		if (pause)
+			t_auditPauses++;
+		else if (t_auditPauses > 0)
+			t_auditPauses--;
+	}
+
+	uint32 GetAuditResults(MemoryAuditEntry* results, uint32 maxResults)
+	{
+		while (g_auditLock.test_and_set(std::memory_order_acquire));
+
+		uint32 numEntries = g_numAuditEntries;
+		for (uint32 i = 0; i < numEntries && i < maxResults; i++)
+			results[i] = g_auditEntries[i];
+
+		g_auditLock.clear(std::memory_order_release);
+
+		return numEntries;
+	}
+
+	void ResetAudit()
+	{
+		while (g_auditLock.test_and_set(std::memory_order_acquire));
+		g_numAuditEntries = 0;
+		g_auditHits.store(0, std::memory_order_relaxed);
+		g_auditLock.clear(std::memory_order_release);
+	}
+
+	struct CallsiteTotals
+	{
+		const char* Filename;
+		uint32 Line;
+		MemoryTag Tag;
+		uint32 Allocations;
+		uint32 Live;
+		uint64 TotalBytes;
+		uint64 LiveBytes;
+	};
+
+	struct CallsiteTable
+	{
+		CallsiteTotals* Entries; // open addressing. Filename and Allocations are 0 when the slot is empty.
+		uint32 Capacity;
+		uint32 Count;
+	};
+
+	inline uint32 hashCallsite(const char* filename, uint32 line, MemoryTag tag)
+	{
+		// every record from the same file has the same __FILE__ pointer, so there's no need to look at the string
+		uint64 h = (uint64)(uintptr_t)filename;
+		h = (h ^ (h >> 29)) * 0x9e3779b97f4a7c15ull;
+		h ^= ((uint64)line << 8) | (uint8)tag;
+		h *= 0xff51afd7ed558ccdull;
+		return (uint32)(h >> 32);
+	}
+
+	CallsiteTotals* findCallsite(CallsiteTable* table, const char* filename, uint32 line, MemoryTag tag)
+	{
+		uint32 mask = table->Capacity - 1;
+		for (uint32 i = hashCallsite(filename, line, tag) & mask; ; i = (i + 1) & mask)
+		{
+			CallsiteTotals* entry = &table->Entries[i];
+			if (entry->Allocations == 0)
+			{
+				entry->Filename = filename;
+				entry->Line = line;
+				entry->Tag = tag;
+				table->Count++;
+				return entry;
+			}
+
+			if (entry->Filename == filename && entry->Line == line && entry->Tag == tag)
+				return entry;
+		}
+	}
+
+	void growCallsiteTable(CallsiteTable* table)
+	{
+		CallsiteTable bigger;
+		bigger.Capacity = table->Capacity * 2;
+		bigger.Count = 0;
+		bigger.Entries = (CallsiteTotals*)calloc(bigger.Capacity, sizeof(CallsiteTotals));
+
+		for (uint32 i = 0; i < table->Capacity; i++)
+		{
+			CallsiteTotals* entry = &table->Entries[i];
+			if (entry->Allocations != 0)
+				*findCallsite(&bigger, entry->Filename, entry->Line, entry->Tag) = *entry;
+		}
+
+		free(table->Entries);
+		*table = bigger;
+	}
+
+	int compareCallsites(const void* a, const void* b)
+	{
+		auto ca = (const CallsiteTotals*)a;
+		auto cb = (const CallsiteTotals*)b;
+
+		// biggest live memory first, then the ones that churned through the most
+		if (ca->LiveBytes != cb->LiveBytes)
+			return ca->LiveBytes > cb->LiveBytes ? -1 : 1;
+		if (ca->TotalBytes != cb->TotalBytes)
+			return ca->TotalBytes > cb->TotalBytes ? -1 : 1;
+		return 0;
+	}
+
+	void DumpReport(const char* filename)
+	{
+		FILE* fp;
+#ifdef _WIN32
+		if (fopen_s(&fp, filename, "w") != 0)
+			fp = nullptr;
+#else
+		fp = fopen(filename, "w");
+#endif
+		if (fp == nullptr)
+			return;
+
+		// one entry per place that allocates, instead of one per allocation ever made
+		CallsiteTable table;
+		table.Capacity = 1024;
+		table.Count = 0;
+		table.Entries = (CallsiteTotals*)calloc(table.Capacity, sizeof(CallsiteTotals));
+
+		for (AllocTracker* tracker = g_trackers.load(std::memory_order_acquire); tracker != nullptr; tracker = tracker->Next)
+		{
+			for (AllocRecordPage* page = tracker->FirstPage; page != nullptr; page = page->Next.load(std::memory_order_acquire))
+			{
+				uint32 numRecords = page->NumRecords.load(std::memory_order_acquire);
+				for (uint32 i = 0; i < numRecords; i++)
+				{
+					AllocRecord* record = &page->Records[i];
+
+					if (table.Count * 2 >= table.Capacity)
+						growCallsiteTable(&table);
+
+					CallsiteTotals* totals = findCallsite(&table, record->Filename, record->Line, record->Tag);
+					totals->Allocations++;
+					totals->TotalBytes += record->RequestedSize;
+					if (record->Freed.load(std::memory_order_relaxed) == 0)
+					{
+						totals->Live++;
+						totals->LiveBytes += record->RequestedSize;
+					}
+				}
+			}
+		}
+
+		// pack them together so they can be sorted
+		uint32 numCallsites = 0;
+		for (uint32 i = 0; i < table.Capacity; i++)
+		{
+			if (table.Entries[i].Allocations != 0)
+				table.Entries[numCallsites++] = table.Entries[i];
+		}
+		qsort(table.Entries, numCallsites, sizeof(CallsiteTotals), compareCallsites);
+
+		MemoryStats stats;
+		GetStats(&stats);
+
+		fprintf(fp, "{\n");
+		fprintf(fp, "\t\"tracking\": %s,\n", stats.Tracking ? "true" : "false");
+		fprintf(fp, "\t\"tags\": [\n");
+		for (uint32 i = 0; i < (uint32)MemoryTag::LAST; i++)
+		{
+			MemoryTagStats* tag = &stats.Tags[i];
+
+			fprintf(fp, "\t\t{ \"name\": \"%s\", \"current\": %llu, \"peak\": %llu, \"count\": %u, \"allocations\": %u, \"softBudget\": %llu, \"hardBudget\": %llu }%s\n",
+				GetMemoryTagName((MemoryTag)i), (unsigned long long)tag->Current, (unsigned long long)tag->Peak, tag->Count, tag->TotalAllocations,
+				(unsigned long long)tag->SoftBudget, (unsigned long long)tag->HardBudget, i + 1 < (uint32)MemoryTag::LAST ? "," : "");
+		}
+		fprintf(fp, "\t],\n");
+
+		fprintf(fp, "\t\"callsites\": [");
+		for (uint32 i = 0; i < numCallsites; i++)
+		{
+			CallsiteTotals* totals = &table.Entries[i];
+
+			fprintf(fp, i == 0 ? "\n\t\t{ \"filename\": " : ",\n\t\t{ \"filename\": ");
+			if (totals->Filename != nullptr)
+				writeJsonString(fp, totals->Filename);
+			else
+				fprintf(fp, "null");
+
+			fprintf(fp, ", \"line\": %u, \"tag\": \"%s\", \"allocations\": %u, \"totalBytes\": %llu, \"live\": %u, \"liveBytes\": %llu }",
+				totals->Line, GetMemoryTagName(totals->Tag), totals->Allocations, (unsigned long long)totals->TotalBytes,
+				totals->Live, (unsigned long long)totals->LiveBytes);
+		}
+		fprintf(fp, "\n\t]\n");
+		fprintf(fp, "}\n");
+
+		free(table.Entries);
+		fclose(fp);
+	}
 }
\ No newline at end of file
@@ -4,6 +4,92 @@
 #include <new>
 #include "Common.h"
 
+struct MemoryFrameStats
+{
+	uint32 Frame;
+	uint32 HeapAllocations;     // heap allocations from any thread during the frame
+	uint32 FrameArenaOverflows; // frame allocations that didn't fit in the arena and went to the heap
+	size_t FrameArenaUsed;
+	size_t FrameArenaSize;
+};
+
+// What an allocation is for, so memory can be budgeted per subsystem. Allocations get whatever tag the
+// thread that made them has set (see MemoryTagScope). Without memory tracking the tags count the size the
+// allocator really handed out, which can be a bit more than was asked for, and each thread's allocations
+// reach the stats (and budgets) in batches of up to 64k or 64 allocations.
+enum class MemoryTag : uint8
+{
+	General,
+	ContentTexture,
+	ContentModel,
+	Audio,
+	Script,
+	Gui,
+	Scene,
+	Transient, // heap memory that's expected to go away again soon, like buffers that only live while something loads
+
+	LAST
+};
+
+inline const char* GetMemoryTagName(MemoryTag tag)
+{
+	static const char* names[] = {
+		"General",
+		"Content/Texture",
+		"Content/Model",
+		"Audio",
+		"Script",
+		"Gui",
+		"Scene",
+		"Transient"
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == (uint32)MemoryTag::LAST, "Every MemoryTag needs a name");
+
+	return (uint32)tag < (uint32)MemoryTag::LAST ? names[(uint32)tag] : "Unknown";
+}
+
+struct MemoryTagStats
+{
+	size_t Current;
+	size_t Peak;
+	uint32 Count;            // live allocations
+	uint32 TotalAllocations;
+
+	size_t SoftBudget;       // 0 means there isn't one
+	size_t HardBudget;
+	uint32 SoftBudgetCrossings; // how many times Current has gone from under the budget to over it
+	uint32 HardBudgetCrossings;
+};
+
+struct MemoryStats
+{
+	bool Tracking; // full tracking, with a record for every allocation (DumpReport() only has callsites with it)
+	size_t KeepUsed;
+	size_t KeepSize;
+	MemoryTagStats Tags[(uint32)MemoryTag::LAST];
+
+	uint32 AuditHits;      // heap calls made while a thread was being audited
+	uint32 AuditCallsites; // different places they came from
+};
+
+// Once the game reaches a steady state the frame shouldn't touch the heap at all (that's what frame and
+// scratch memory are for). Audit mode is how to make sure of that.
+enum class MemoryAuditMode : uint8
+{
+	Off,
+	Count, // count every Alloc/Realloc/Free by file and line
+	Abort  // print where the first one came from (with a backtrace) and abort
+};
+
+struct MemoryAuditEntry
+{
+	const char* Filename;
+	uint32 Line;
+	uint32 Allocs;
+	uint32 Reallocs;
+	uint32 Frees;
+};
+
 struct MemoryManager
 {
 	void* (*Alloc)(size_t amount);
@@ -18,7 +104,29 @@ struct MemoryManager
 	void (*Free)(void* memory);
 	void (*FreeTrack)(void* memory, const char* filename, int line);
 
+	// for things that live until the game exits. Free() ignores it, but don't Realloc() it.
 	void* (*AllocAndKeep)(size_t amount, const char* filename, int line);
+
+	// Frame memory is good until the end of the next frame (there are two arenas and they take turns),
+	// and never gets freed individually. Any thread can use it, as long as it's done with it by then.
+	void* (*FrameAlloc)(size_t amount, size_t alignment);
+	void (*NextFrame)(); // main thread only, at the start of each frame
+	void (*GetFrameStats)(MemoryFrameStats* result); // stats for the last frame that finished
+
+	// per-thread scratch memory, see ScratchScope
+	void* (*ScratchAlloc)(size_t amount, size_t alignment);
+	size_t (*ScratchMark)();
+	void (*ScratchRelease)(size_t mark);
+
+	MemoryTag (*SetTag)(MemoryTag tag); // for the current thread. Returns the old one.
+	void (*SetBudget)(MemoryTag tag, size_t softBudget, size_t hardBudget);
+	void (*GetStats)(MemoryStats* result);
+	void (*DumpReport)(const char* filename); // live and total memory for each place that allocates, as json
+
+	MemoryAuditMode (*SetAuditMode)(MemoryAuditMode mode); // for the current thread. Returns the old one.
+	void (*PauseAudit)(bool pause); // for the current thread. Pauses nest, see MemoryAuditPause.
+	uint32 (*GetAuditResults)(MemoryAuditEntry* results, uint32 maxResults); // in the order they were first seen. Returns how many there are.
+	void (*ResetAudit)();
 };
 
 extern MemoryManager* g_memory;
@@ -32,6 +140,51 @@ T* NewObject(const char* filename, int line)
 	return new(memory) T();
 }
 
+// Scratch memory for jobs and other short-lived work. Everything allocated through the scope is
+// released when it goes away. Scopes can nest, but don't keep one open across JobQueue::WaitForJob(),
+// since the job could resume on a different thread.
+class ScratchScope
+{
+	size_t m_mark;
+
+public:
+	ScratchScope() { m_mark = g_memory->ScratchMark(); }
+	~ScratchScope() { g_memory->ScratchRelease(m_mark); }
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+
+	void* Alloc(size_t amount, size_t alignment = 16) { return g_memory->ScratchAlloc(amount, alignment); }
+
+	template<typename T>
+	T* AllocArray(size_t count) { return (T*)g_memory->ScratchAlloc(sizeof(T) * count, alignof(T)); }
+};
+
+// Tags everything the current thread allocates until it goes away
+class MemoryTagScope
+{
+	MemoryTag m_previous;
+
+public:
+	MemoryTagScope(MemoryTag tag) { m_previous = g_memory->SetTag(tag); }
+	~MemoryTagScope() { g_memory->SetTag(m_previous); }
+
+	MemoryTagScope(const MemoryTagScope&) = delete;
+	MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+};
+
+// Stops auditing the current thread until it goes away, for things that are allowed to
+// allocate even in a steady state (loading a scene, running a console command)
+class MemoryAuditPause
+{
+public:
+	MemoryAuditPause() { g_memory->PauseAudit(true); }
+	~MemoryAuditPause() { g_memory->PauseAudit(false); }
+
+	MemoryAuditPause(const MemoryAuditPause&) = delete;
+	MemoryAuditPause& operator=(const MemoryAuditPause&) = delete;
+};
+
 #if !defined GAME_ENABLE_HOTLOAD || !defined GAME_ENABLE_HOTLOAD_DLL
 
 namespace MemoryManagerInternal
@@ -55,6 +208,23 @@ namespace MemoryManagerInternal
 
 	void* AllocAndKeep(size_t amount, const char* filename, int line);
 
+	void* FrameAlloc(size_t amount, size_t alignment);
+	void NextFrame();
+	void GetFrameStats(MemoryFrameStats* result);
+
+	void* ScratchAlloc(size_t amount, size_t alignment);
+	size_t ScratchMark();
+	void ScratchRelease(size_t mark);
+
+	MemoryTag SetTag(MemoryTag tag);
+	void SetBudget(MemoryTag tag, size_t softBudget, size_t hardBudget);
+	void GetStats(MemoryStats* result);
+
+	MemoryAuditMode SetAuditMode(MemoryAuditMode mode);
+	void PauseAudit(bool pause);
+	uint32 GetAuditResults(MemoryAuditEntry* results, uint32 maxResults);
+	void ResetAudit();
+
 	void GetMemoryUsage(size_t* usage);
 	void DumpReport(const char* filename);
 }
@@ -1,8 +1,8 @@
-#define NXNA_ENABLE_RENDERER
-#ifdef _WIN32
-#define NXNA_ENABLE_DIRECT3D11
-#endif
-#define NXNA_ENABLE_SPRITEBATCH
-#define NXNA_ENABLE_MATH
-#define NXNA_ENABLE_INPUT
-#include "Nxna2.h"
+#define NXNA_ENABLE_RENDERER
+#ifdef _WIN32
+#define NXNA_ENABLE_DIRECT3D11
+#endif
+#define NXNA_ENABLE_SPRITEBATCH
+#define NXNA_ENABLE_MATH
+#define NXNA_ENABLE_INPUT
+#include "Nxna2.h"
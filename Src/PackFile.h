@@ -0,0 +1,58 @@
+#ifndef PACKFILE_H
+#define PACKFILE_H
+
+#include "Common.h"
+
+// A pack file is a whole content directory in one file, so FileFinder can map it once at startup
+// instead of opening and mapping every asset on its own. Tools/Packer builds them. The layout is:
+//
+//   PackHeader
+//   PackEntry[NumEntries], sorted by NameHash (and then by name)
+//   PackBlock[NumBlocks]
+//   the names, each one null terminated
+//   the files, each one starting on a PackHeader::Alignment boundary
+//
+// Names are paths relative to the content directory with forward slashes (like "Models/test_room.obj"),
+// and NameHash is Utils::CalcHash() of the name, same as the rest of the content system uses.
+//
+// Files can be compressed (see lz4block.h). A compressed file is split into BlockSize chunks that are each
+// compressed on their own, so they can all be decompressed at the same time. Any block that didn't get
+// smaller is stored as is, which is the case exactly when its CompressedSize is the same as its real size.
+
+struct PackHeader
+{
+	static const uint32 Magic = 0x4b415047; // "GPAK"
+	static const uint32 CurrentVersion = 2;
+	static const uint32 Alignment = 64;
+	static const uint32 DefaultBlockSize = 64 * 1024;
+
+	uint32 FourCC;
+	uint32 Version;
+	uint32 NumEntries;
+	uint32 NamesSize;
+	uint32 NumBlocks;
+	uint32 BlockSize; // every block but the last one in a file is exactly this big once it's decompressed
+};
+
+struct PackEntry
+{
+	uint32 NameHash;
+	uint32 NameOffset; // from the start of the names
+	uint64 Offset;     // from the start of the pack file
+	uint64 Size;       // once it's decompressed
+	uint64 StoredSize; // how much of the pack file it takes up (same as Size if it isn't compressed)
+	uint32 FirstBlock;
+	uint32 NumBlocks;  // 0 if it isn't compressed
+};
+
+struct PackBlock
+{
+	uint32 Offset; // from the start of the file's data
+	uint32 CompressedSize;
+};
+
+static_assert(sizeof(PackHeader) == 24, "PackHeader is unexpected size");
+static_assert(sizeof(PackEntry) == 40, "PackEntry is unexpected size");
+static_assert(sizeof(PackBlock) == 8, "PackBlock is unexpected size");
+
+#endif // PACKFILE_H
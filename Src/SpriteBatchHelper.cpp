@@ -1,3 +1,3 @@
-#include "SpriteBatchHelper.h"
-
+#include "SpriteBatchHelper.h"
+
 SpriteBatchData* SpriteBatchHelper::m_data = nullptr;
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "StringManager.h"
 #include "iniparse.h"
 #include "Logging.h"
+#include "FileFinder.h"
 #include "ConsoleCommand.h"
 #include <cassert>
 
@@ -82,9 +83,9 @@ void StringManager::Init(const char* languageCode, const char* regionCode)
 	char languagePath[256];
 	char regionPath[256];
 
-	snprintf(globalPath, 256, "Content/text.txt");
-	snprintf(languagePath, 256, "Content/text_%s.txt", languageCode);
-	snprintf(regionPath, 256, "Content/text_%s_%s.txt", languageCode, regionCode);
+	snprintf(globalPath, 256, "text.txt");
+	snprintf(languagePath, 256, "text_%s.txt", languageCode);
+	snprintf(regionPath, 256, "text_%s_%s.txt", languageCode, regionCode);
 	globalPath[255] = languagePath[255] = regionPath[255] = 0;
 
 	const char* source[StringManagerData::Capacity];
@@ -93,14 +94,14 @@ void StringManager::Init(const char* languageCode, const char* regionCode)
 
 	ini_context ctx;
 	ini_item item;
-	File globalFile;
-	File languageFile;
-	File regionFile;
+	FoundFile globalFile = {};
+	FoundFile languageFile = {};
+	FoundFile regionFile = {};
 	const char* path = globalPath;
-	File* file = &globalFile;
+	FoundFile* file = &globalFile;
 
 doit:
-	if (FileSystem::OpenAndMap(path, file))
+	if (FileFinder::OpenAndMap(path, file))
 	{
 		ini_init(&ctx, (const char*)file->Memory, (const char*)file->Memory + file->FileSize);
 		
@@ -174,9 +175,9 @@ doit:
 	}
 
 done:
-	FileSystem::Close(&globalFile);
-	FileSystem::Close(&languageFile);
-	FileSystem::Close(&regionFile);
+	FileFinder::Close(&globalFile);
+	FileFinder::Close(&languageFile);
+	FileFinder::Close(&regionFile);
 
 	ConsoleCommand cmd;
 	cmd.Command = "reload_strings";
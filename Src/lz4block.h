@@ -0,0 +1,267 @@
+#ifndef LZ4BLOCK_H
+#define LZ4BLOCK_H
+
+// Compresses and decompresses single blocks in the LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md),
+// which is what the pack files use for compressed content. There's no frame format, no checksums, and no dictionaries,
+// just fast greedy compression and a decompressor that's safe to run on data that's been corrupted.
+
+// preprocessor options:
+// LZ4BLOCK_MEMCPY - overrides the default memcpy implementation
+// LZ4BLOCK_HASH_LOG - log2 of the number of entries in the compressor's match table (which lives on the stack)
+
+#ifndef LZ4BLOCK_MEMCPY
+#define LZ4BLOCK_MEMCPY memcpy
+#endif
+
+#ifndef LZ4BLOCK_HASH_LOG
+#define LZ4BLOCK_HASH_LOG 14
+#endif
+
+// the most lz4block_compress() can need for sourceSize bytes (when nothing compresses at all)
+int lz4block_compress_bound(int sourceSize);
+
+// returns the compressed size, or 0 if it wouldn't fit in destCapacity
+int lz4block_compress(const void* source, int sourceSize, void* dest, int destCapacity);
+
+// returns the decompressed size, or -1 if the data is bad or it wouldn't fit in destCapacity
+int lz4block_decompress(const void* source, int sourceSize, void* dest, int destCapacity);
+
+#endif // LZ4BLOCK_H
+
+#ifdef LZ4BLOCK_IMPLEMENTATION
+
+#include <string.h>
+
+// the format says matches are at least this long, can't start in the last 12 bytes, and can't cover the last 5
+#define LZ4BLOCK_MIN_MATCH 4
+#define LZ4BLOCK_MATCH_LIMIT 12
+#define LZ4BLOCK_LAST_LITERALS 5
+#define LZ4BLOCK_MAX_OFFSET 65535
+
+static unsigned int lz4block_read32(const unsigned char* p)
+{
+	unsigned int result;
+	LZ4BLOCK_MEMCPY(&result, p, sizeof(result));
+	return result;
+}
+
+static unsigned int lz4block_hash(unsigned int sequence)
+{
+	return (sequence * 2654435761u) >> (32 - LZ4BLOCK_HASH_LOG);
+}
+
+static unsigned char* lz4block_write_length(unsigned char* op, int length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (unsigned char)length;
+
+	return op;
+}
+
+static unsigned char* lz4block_write_sequence(unsigned char* op, unsigned char* opEnd, const unsigned char* literals, int numLiterals, int offset, int matchLength)
+{
+	// the worst case, so there's only one check
+	int needed = 1 + numLiterals / 255 + 1 + numLiterals + (matchLength > 0 ? 2 + matchLength / 255 + 1 : 0);
+	if (needed > opEnd - op)
+		return nullptr;
+
+	unsigned char* token = op++;
+	*token = (unsigned char)((numLiterals < 15 ? numLiterals : 15) << 4);
+	if (numLiterals >= 15)
+		op = lz4block_write_length(op, numLiterals - 15);
+
+	LZ4BLOCK_MEMCPY(op, literals, numLiterals);
+	op += numLiterals;
+
+	if (matchLength > 0)
+	{
+		*op++ = (unsigned char)(offset & 0xff);
+		*op++ = (unsigned char)(offset >> 8);
+
+		int length = matchLength - LZ4BLOCK_MIN_MATCH;
+		*token |= (unsigned char)(length < 15 ? length : 15);
+		if (length >= 15)
+			op = lz4block_write_length(op, length - 15);
+	}
+
+	return op;
+}
+
+int lz4block_compress_bound(int sourceSize)
+{
+	return sourceSize + sourceSize / 255 + 16;
+}
+
+int lz4block_compress(const void* source, int sourceSize, void* dest, int destCapacity)
+{
+	const unsigned char* src = (const unsigned char*)source;
+	const unsigned char* ip = src;
+	const unsigned char* end = src + sourceSize;
+	const unsigned char* anchor = src;
+	unsigned char* op = (unsigned char*)dest;
+	unsigned char* opEnd = op + destCapacity;
+
+	if (sourceSize < 0)
+		return 0;
+
+	// positions + 1, so 0 means there's nothing there
+	unsigned int table[1 << LZ4BLOCK_HASH_LOG];
+	memset(table, 0, sizeof(table));
+
+	if (sourceSize > LZ4BLOCK_MATCH_LIMIT)
+	{
+		const unsigned char* matchStartLimit = end - LZ4BLOCK_MATCH_LIMIT;
+		const unsigned char* matchEndLimit = end - LZ4BLOCK_LAST_LITERALS;
+
+		while (ip < matchStartLimit)
+		{
+			unsigned int sequence = lz4block_read32(ip);
+			unsigned int hash = lz4block_hash(sequence);
+			unsigned int candidate = table[hash];
+			table[hash] = (unsigned int)(ip - src) + 1;
+
+			if (candidate == 0 || (ip - src) - (candidate - 1) > LZ4BLOCK_MAX_OFFSET || lz4block_read32(src + candidate - 1) != sequence)
+			{
+				ip++;
+				continue;
+			}
+
+			const unsigned char* match = src + candidate - 1;
+
+			// see how far the match goes
+			const unsigned char* matchEnd = ip + LZ4BLOCK_MIN_MATCH;
+			const unsigned char* ref = match + LZ4BLOCK_MIN_MATCH;
+			while (matchEnd < matchEndLimit && *matchEnd == *ref)
+			{
+				matchEnd++;
+				ref++;
+			}
+
+			op = lz4block_write_sequence(op, opEnd, anchor, (int)(ip - anchor), (int)(ip - match), (int)(matchEnd - ip));
+			if (op == nullptr)
+				return 0;
+
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+
+	// whatever's left over is just literals
+	op = lz4block_write_sequence(op, opEnd, anchor, (int)(end - anchor), 0, 0);
+	if (op == nullptr)
+		return 0;
+
+	return (int)(op - (unsigned char*)dest);
+}
+
+int lz4block_decompress(const void* source, int sourceSize, void* dest, int destCapacity)
+{
+	const unsigned char* ip = (const unsigned char*)source;
+	const unsigned char* ipEnd = ip + sourceSize;
+	unsigned char* op = (unsigned char*)dest;
+	unsigned char* opEnd = op + destCapacity;
+
+	if (sourceSize <= 0 || destCapacity < 0)
+		return -1;
+
+	while (true)
+	{
+		if (ip >= ipEnd)
+			return -1;
+
+		unsigned int token = *ip++;
+
+		size_t numLiterals = token >> 4;
+
+		// most sequences are short, so if there's room just copy a fixed 16 bytes (which ends up being a couple of moves)
+		if (numLiterals < 15 && ipEnd - ip >= 16 && opEnd - op >= 16)
+		{
+			LZ4BLOCK_MEMCPY(op, ip, 16);
+			ip += numLiterals;
+			op += numLiterals;
+		}
+		else
+		{
+			if (numLiterals == 15)
+			{
+				unsigned char b;
+				do
+				{
+					if (ip >= ipEnd)
+						return -1;
+					b = *ip++;
+					numLiterals += b;
+				} while (b == 255);
+			}
+
+			if (numLiterals > (size_t)(ipEnd - ip) || numLiterals > (size_t)(opEnd - op))
+				return -1;
+
+			LZ4BLOCK_MEMCPY(op, ip, numLiterals);
+			ip += numLiterals;
+			op += numLiterals;
+		}
+
+		// the last sequence doesn't have a match
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return -1;
+
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - (unsigned char*)dest))
+			return -1;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15)
+		{
+			unsigned char b;
+			do
+			{
+				if (ip >= ipEnd)
+					return -1;
+				b = *ip++;
+				matchLength += b;
+			} while (b == 255);
+		}
+		matchLength += LZ4BLOCK_MIN_MATCH;
+
+		if (matchLength > (size_t)(opEnd - op))
+			return -1;
+
+		const unsigned char* match = op - offset;
+		if (offset >= 8 && (size_t)(opEnd - op) >= matchLength + 8)
+		{
+			// 8 bytes at a time can't overlap, and it's fine to write a little past the end since there's room
+			unsigned char* copyEnd = op + matchLength;
+			do
+			{
+				LZ4BLOCK_MEMCPY(op, match, 8);
+				op += 8;
+				match += 8;
+			} while (op < copyEnd);
+			op = copyEnd;
+		}
+		else if (offset >= matchLength)
+		{
+			LZ4BLOCK_MEMCPY(op, match, matchLength);
+			op += matchLength;
+		}
+		else
+		{
+			// the match overlaps what it's writing (that's how runs get encoded), so it has to go a byte at a time
+			for (size_t i = 0; i < matchLength; i++)
+				*op++ = *match++;
+		}
+	}
+
+	return (int)(op - (unsigned char*)dest);
+}
+
+#endif // LZ4BLOCK_IMPLEMENTATION
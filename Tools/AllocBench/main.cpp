@@ -0,0 +1,217 @@
+// Headless allocator benchmark. Runs the same allocation patterns through plain malloc()/free() and
+// through g_memory, and writes the results as JSON so allocator changes can be compared against a baseline.
+//
+// Usage: allocbench [-t threads] [-n operations] [-o output.json]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "../../Src/MemoryManager.cpp"
+#include "../../Src/Utils.cpp"
+
+MemoryManager* g_memory;
+
+struct Options
+{
+	uint32 NumThreads;
+	uint32 NumOperations;
+	const char* OutputFile;
+};
+
+struct Allocator
+{
+	const char* Name;
+	void* (*Alloc)(size_t amount);
+	void (*Free)(void* memory);
+};
+
+static void* memoryManagerAlloc(size_t amount) { return g_memory->AllocTrack(amount, __FILE__, __LINE__); }
+static void memoryManagerFree(void* memory) { g_memory->FreeTrack(memory, __FILE__, __LINE__); }
+
+static const Allocator Allocators[] = {
+	{ "malloc", malloc, free },
+	{ "memoryManager", memoryManagerAlloc, memoryManagerFree }
+};
+static const uint32 NumAllocators = sizeof(Allocators) / sizeof(Allocators[0]);
+
+static const uint32 NumLiveAllocations = 1024;
+static const uint32 MaxThreads = 16;
+
+// simple xorshift, so every allocator sees exactly the same sizes
+static uint32 nextRandom(uint32* state)
+{
+	uint32 x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+// keeps a window of live allocations and keeps replacing random ones, touching each one like real code would
+static void churn(const Allocator* allocator, uint32 numOperations, uint32 maxSize, uint32 seed)
+{
+	void* live[NumLiveAllocations] = {};
+	uint32 random = seed;
+
+	for (uint32 i = 0; i < numOperations; i++)
+	{
+		uint32 slot = nextRandom(&random) % NumLiveAllocations;
+		allocator->Free(live[slot]);
+
+		uint32 size = nextRandom(&random) % maxSize + 1;
+		live[slot] = allocator->Alloc(size);
+		*(uint8*)live[slot] = (uint8)i;
+	}
+
+	for (uint32 i = 0; i < NumLiveAllocations; i++)
+		allocator->Free(live[i]);
+}
+
+// something like loading a scene: lots of allocations of all sizes that all get freed at the end
+static void load(const Allocator* allocator, uint32 numOperations, uint32 seed)
+{
+	const uint32 batchSize = 4096;
+	void* batch[batchSize];
+	uint32 random = seed;
+
+	for (uint32 i = 0; i < numOperations; i += batchSize)
+	{
+		for (uint32 j = 0; j < batchSize; j++)
+		{
+			// mostly small bookkeeping, with the occasional big buffer
+			uint32 r = nextRandom(&random);
+			uint32 size = (r & 63) == 0 ? r % (256 * 1024) + 1 : r % 256 + 1;
+			batch[j] = allocator->Alloc(size);
+			memset(batch[j], 0, size < 64 ? size : 64);
+		}
+
+		for (uint32 j = 0; j < batchSize; j++)
+			allocator->Free(batch[j]);
+	}
+}
+
+static double runChurn(const Allocator* allocator, uint32 numThreads, uint32 numOperations, uint32 maxSize)
+{
+	Utils::Stopwatch timer;
+	timer.Start();
+
+	std::thread threads[MaxThreads];
+	for (uint32 i = 0; i < numThreads; i++)
+		threads[i] = std::thread(churn, allocator, numOperations / numThreads, maxSize, 1234 + i);
+	for (uint32 i = 0; i < numThreads; i++)
+		threads[i].join();
+
+	uint64 microseconds = timer.GetElapsedMicroseconds();
+	return microseconds > 0 ? numOperations * 1000000.0 / microseconds : 0;
+}
+
+static uint64 runLoad(const Allocator* allocator, uint32 numOperations)
+{
+	Utils::Stopwatch timer;
+	timer.Start();
+
+	load(allocator, numOperations, 1234);
+
+	return timer.GetElapsedMicroseconds();
+}
+
+static bool parseOptions(int argc, char** argv, Options* result)
+{
+	uint32 numCores = std::thread::hardware_concurrency();
+
+	result->NumThreads = numCores > 1 ? numCores : 2;
+	result->NumOperations = 4000000;
+	result->OutputFile = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			result->NumThreads = (uint32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			result->NumOperations = (uint32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			result->OutputFile = argv[++i];
+		else
+			return false;
+	}
+
+	if (result->NumThreads == 0 || result->NumThreads > MaxThreads || result->NumOperations == 0)
+		return false;
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (parseOptions(argc, argv, &options) == false)
+	{
+		printf("Usage:\n");
+		printf("\tallocbench [-t threads] [-n operations] [-o output.json]\n");
+		return -1;
+	}
+
+	MemoryManager mem;
+	g_memory = &mem;
+	MemoryManagerInternal::SetDefaults(g_memory);
+	MemoryManagerInternal::Initialize();
+
+	FILE* fp = stdout;
+	if (options.OutputFile)
+	{
+#ifdef _WIN32
+		if (fopen_s(&fp, options.OutputFile, "w") != 0)
+			fp = nullptr;
+#else
+		fp = fopen(options.OutputFile, "w");
+#endif
+		if (fp == nullptr)
+		{
+			printf("Unable to open %s\n", options.OutputFile);
+			return -1;
+		}
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"hardwareThreads\": %u,\n", std::thread::hardware_concurrency());
+	fprintf(fp, "\t\"operations\": %u,\n", options.NumOperations);
+#ifdef MEM_SLAB_ALLOC
+	fprintf(fp, "\t\"slab\": true,\n");
+#else
+	fprintf(fp, "\t\"slab\": false,\n");
+#endif
+#ifdef MEM_BASIC_ALLOC
+	fprintf(fp, "\t\"tracking\": false,\n");
+#else
+	fprintf(fp, "\t\"tracking\": true,\n");
+#endif
+	fprintf(fp, "\t\"allocators\": [\n");
+
+	for (uint32 i = 0; i < NumAllocators; i++)
+	{
+		const Allocator* allocator = &Allocators[i];
+
+		fprintf(fp, "\t\t{\n");
+		fprintf(fp, "\t\t\t\"name\": \"%s\",\n", allocator->Name);
+		fprintf(fp, "\t\t\t\"smallOpsPerSecond\": %.0f,\n", runChurn(allocator, 1, options.NumOperations, 256));
+		fprintf(fp, "\t\t\t\"mixedOpsPerSecond\": %.0f,\n", runChurn(allocator, 1, options.NumOperations, 4096));
+		fprintf(fp, "\t\t\t\"threadedOpsPerSecond\": %.0f,\n", runChurn(allocator, options.NumThreads, options.NumOperations, 256));
+		fprintf(fp, "\t\t\t\"threads\": %u,\n", options.NumThreads);
+		fprintf(fp, "\t\t\t\"loadMicroseconds\": %llu\n", (unsigned long long)runLoad(allocator, options.NumOperations / 4));
+		fprintf(fp, "\t\t}%s\n", i + 1 < NumAllocators ? "," : "");
+		fflush(fp);
+	}
+
+	fprintf(fp, "\t]\n");
+	fprintf(fp, "}\n");
+
+	if (fp != stdout)
+		fclose(fp);
+
+	MemoryManagerInternal::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,700 @@
+// Headless JobQueue benchmark. Builds the job queue on its own (no SDL, no GL, no Nxna) and
+// writes the results as JSON so scheduler changes can be compared against a baseline run.
+// With -verify it checks that the job queue does what it says instead of timing it, which is
+// most useful in a build with the sanitizers turned on (see the makefile).
+//
+// Usage: jobbench [-t maxWorkers] [-n jobs] [-pin] [-o output.json]
+//        jobbench -verify [-t maxWorkers] [-pin]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "../../Src/MemoryManager.cpp"
+#include "../../Src/Logging.cpp"
+#include "../../Src/Utils.cpp"
+#include "../../Src/JobQueue.cpp"
+
+MemoryManager* g_memory;
+
+// there's no console here, so there's nowhere to put the job queue's commands
+void Gui::Console::AddCommands(ConsoleCommand* commands, uint32 numCommands)
+{
+}
+
+struct Options
+{
+	uint32 MaxWorkers;
+	uint32 NumJobs;
+	bool PinThreads;
+	bool Verify;
+	const char* OutputFile;
+};
+
+struct BenchResult
+{
+	uint64 Jobs;
+	uint64 Microseconds;
+};
+
+// the drain benchmark holds every job until the main thread gets to it, so it has to fit in the pool
+static const uint32 MaxJobsInFlight = JobQueueData::MaxJobs / 2;
+static const uint32 FanOutChildren = 64;
+static const uint32 MaxProducers = 8;
+
+static std::atomic<uint32> g_completed;
+static std::atomic<uint32> g_mainCompleted;
+
+static bool emptyJob(void* data)
+{
+	g_completed.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+static bool mainThreadJob(void* data)
+{
+	g_mainCompleted++;
+	return true;
+}
+
+static bool fanOutJob(void* data)
+{
+	JobHandle self = JobQueue::GetCurrentJob();
+	for (uint32 i = 0; i < FanOutChildren; i++)
+	{
+		while (JobQueue::AddDependantJob(self, emptyJob, nullptr, nullptr, nullptr, 0) == JobQueue::INVALID_JOB)
+			std::this_thread::yield();
+	}
+
+	return true;
+}
+
+static void addJob(JobFunc asyncFunc, JobFunc mainThreadFunc)
+{
+	// the pool is full, so wait for the workers to catch up
+	while (JobQueue::AddJob(asyncFunc, mainThreadFunc, nullptr, nullptr, 0) == JobQueue::INVALID_JOB)
+		std::this_thread::yield();
+}
+
+static void waitForCompleted(uint32 count)
+{
+	while (g_completed.load(std::memory_order_relaxed) < count)
+	{
+		JobQueue::Tick();
+		std::this_thread::yield();
+	}
+}
+
+static double perSecond(const BenchResult& result)
+{
+	return result.Microseconds > 0 ? result.Jobs * 1000000.0 / result.Microseconds : 0;
+}
+
+// Empty jobs added from the main thread as fast as it can go
+static BenchResult benchEmptyJobs(uint32 numJobs)
+{
+	g_completed = 0;
+
+	Utils::Stopwatch timer;
+	timer.Start();
+
+	for (uint32 i = 0; i < numJobs; i++)
+		addJob(emptyJob, nullptr);
+	waitForCompleted(numJobs);
+
+	return { numJobs, timer.GetElapsedMicroseconds() };
+}
+
+// One parent per round adds FanOutChildren dependant jobs, and the main thread waits for the parent
+static BenchResult benchFanOut(uint32 numJobs)
+{
+	uint32 rounds = numJobs / FanOutChildren;
+	if (rounds == 0) rounds = 1;
+
+	g_completed = 0;
+
+	Utils::Stopwatch timer;
+	timer.Start();
+
+	for (uint32 i = 0; i < rounds; i++)
+	{
+		JobInfo info;
+		JobQueue::AddJob(fanOutJob, nullptr, &info, nullptr, 0);
+		JobQueue::WaitForJob(&info);
+	}
+
+	return { (uint64)rounds * (FanOutChildren + 1), timer.GetElapsedMicroseconds() };
+}
+
+// Only measures the main thread running MainThreadFuncs, once the async halves are all out of the way
+static BenchResult benchMainThreadDrain(uint32 numJobs)
+{
+	if (numJobs > MaxJobsInFlight)
+		numJobs = MaxJobsInFlight;
+
+	g_completed = 0;
+	g_mainCompleted = 0;
+
+	for (uint32 i = 0; i < numJobs; i++)
+		addJob(emptyJob, mainThreadJob);
+	while (g_completed.load(std::memory_order_relaxed) < numJobs)
+		std::this_thread::yield();
+
+	Utils::Stopwatch timer;
+	timer.Start();
+
+	while (g_mainCompleted < numJobs)
+		JobQueue::Tick();
+
+	return { numJobs, timer.GetElapsedMicroseconds() };
+}
+
+static void producerProc(uint32 numJobs)
+{
+	for (uint32 i = 0; i < numJobs; i++)
+		addJob(emptyJob, nullptr);
+}
+
+// Several threads that aren't workers all adding jobs at once
+static BenchResult benchContention(uint32 numJobs, uint32 numProducers)
+{
+	uint32 jobsPerProducer = numJobs / numProducers;
+
+	g_completed = 0;
+
+	Utils::Stopwatch timer;
+	timer.Start();
+
+	std::thread producers[MaxProducers];
+	for (uint32 i = 0; i < numProducers; i++)
+		producers[i] = std::thread(producerProc, jobsPerProducer);
+	for (uint32 i = 0; i < numProducers; i++)
+		producers[i].join();
+
+	waitForCompleted(jobsPerProducer * numProducers);
+
+	return { (uint64)jobsPerProducer * numProducers, timer.GetElapsedMicroseconds() };
+}
+
+static void writeResult(FILE* fp, const char* name, const BenchResult& result, bool comma)
+{
+	fprintf(fp, "\t\t\t\"%s\": { \"jobs\": %llu, \"microseconds\": %llu, \"jobsPerSecond\": %.0f }%s\n",
+		name, (unsigned long long)result.Jobs, (unsigned long long)result.Microseconds, perSecond(result), comma ? "," : "");
+}
+
+static void runBenchmarks(FILE* fp, const Options& options, uint32 numWorkers, bool last)
+{
+	JobQueueData* data = nullptr;
+	JobQueue::SetGlobalData(&data, numWorkers, options.PinThreads);
+
+	// warm up, so the pool has already grown before anything gets timed
+	benchEmptyJobs(MaxJobsInFlight);
+
+	BenchResult empty = benchEmptyJobs(options.NumJobs);
+	BenchResult fanOut = benchFanOut(options.NumJobs);
+	BenchResult drain = benchMainThreadDrain(options.NumJobs);
+
+	fprintf(fp, "\t\t{\n");
+	fprintf(fp, "\t\t\t\"workers\": %u,\n", numWorkers);
+	writeResult(fp, "emptyJobs", empty, true);
+	writeResult(fp, "fanOut", fanOut, true);
+	writeResult(fp, "mainThreadDrain", drain, true);
+
+	fprintf(fp, "\t\t\t\"contention\": [\n");
+	for (uint32 producers = 1; producers <= MaxProducers; producers *= 2)
+	{
+		BenchResult contention = benchContention(options.NumJobs, producers);
+		fprintf(fp, "\t\t\t\t{ \"producers\": %u, \"jobs\": %llu, \"microseconds\": %llu, \"jobsPerSecond\": %.0f }%s\n",
+			producers, (unsigned long long)contention.Jobs, (unsigned long long)contention.Microseconds, perSecond(contention),
+			producers * 2 <= MaxProducers ? "," : "");
+	}
+	fprintf(fp, "\t\t\t]\n");
+	fprintf(fp, "\t\t}%s\n", last ? "" : ",");
+
+	JobQueue::Shutdown(true);
+}
+
+static uint32 g_failures;
+
+static bool check(bool condition, const char* what, uint32 workers)
+{
+	if (condition == false)
+	{
+		printf("FAILED with %u workers: %s\n", workers, what);
+		g_failures++;
+	}
+
+	return condition;
+}
+
+static void waitForJob(JobInfo* info)
+{
+	JobQueue::WaitForJob(info);
+}
+
+// ParallelFor has to hit every index exactly once, whatever the grain, and from inside a job too
+static const uint32 ParallelForBegin = 5;
+static const uint32 ParallelForEnd = 100003;
+static std::atomic<uint8> g_parallelForCounts[ParallelForEnd + 5];
+
+static void countIndices(uint32 start, uint32 end, void* param)
+{
+	for (uint32 i = start; i < end; i++)
+		g_parallelForCounts[i].fetch_add(1, std::memory_order_relaxed);
+}
+
+static bool parallelForCounts()
+{
+	for (uint32 i = 0; i < sizeof(g_parallelForCounts) / sizeof(g_parallelForCounts[0]); i++)
+	{
+		uint8 expected = i >= ParallelForBegin && i < ParallelForEnd ? 1 : 0;
+		if (g_parallelForCounts[i] != expected)
+			return false;
+	}
+
+	return true;
+}
+
+static bool parallelForJob(void* data)
+{
+	JobQueue::ParallelFor(ParallelForBegin, ParallelForEnd, *(uint32*)data, countIndices, nullptr);
+	return true;
+}
+
+static void verifyParallelFor(uint32 workers)
+{
+	const uint32 grains[] = { 1, 7, 64, 1000, ParallelForEnd };
+	for (uint32 grain : grains)
+	{
+		for (auto& count : g_parallelForCounts) count = 0;
+		JobQueue::ParallelFor(ParallelForBegin, ParallelForEnd, grain, countIndices, nullptr);
+		if (check(parallelForCounts(), "ParallelFor from the main thread hits every index once", workers) == false)
+			break;
+
+		for (auto& count : g_parallelForCounts) count = 0;
+		JobInfo info;
+		JobQueue::AddJob(parallelForJob, nullptr, &info, &grain, sizeof(grain), JobPriority::Background);
+		waitForJob(&info);
+		if (check(parallelForCounts(), "ParallelFor from a job hits every index once", workers) == false)
+			break;
+	}
+}
+
+// A -> B, A -> C, B and C -> D. Every task runs once, and only after the ones before it.
+struct Diamond
+{
+	std::atomic<uint32> Sequence;
+	std::atomic<uint32> Runs[4];
+	uint32 Order[4];
+	bool FailFirst;
+	JobInfo Result;
+};
+
+struct DiamondTask
+{
+	Diamond* Graph;
+	uint32 Index;
+};
+
+static bool diamondTask(void* data)
+{
+	DiamondTask* task = (DiamondTask*)data;
+	task->Graph->Order[task->Index] = task->Graph->Sequence++;
+	task->Graph->Runs[task->Index]++;
+
+	return task->Index != 0 || task->Graph->FailFirst == false;
+}
+
+static void submitDiamond(Diamond* graph, DiamondTask* tasks, bool failFirst)
+{
+	graph->Sequence = 0;
+	graph->FailFirst = failFirst;
+
+	TaskGraph g;
+	TaskID ids[4];
+	for (uint32 i = 0; i < 4; i++)
+	{
+		graph->Runs[i] = 0;
+		tasks[i].Graph = graph;
+		tasks[i].Index = i;
+		ids[i] = g.AddTask(diamondTask, &tasks[i]);
+	}
+
+	g.AddDependency(ids[0], ids[1]);
+	g.AddDependency(ids[0], ids[2]);
+	g.AddDependency(ids[1], ids[3]);
+	g.AddDependency(ids[2], ids[3]);
+
+	while (g.Submit(&graph->Result, JobPriority::LoadCritical) == JobQueue::INVALID_JOB)
+		JobQueue::Tick();
+}
+
+static void verifyTaskGraphs(uint32 workers)
+{
+	static const uint32 NumGraphs = 2000;
+	static const uint32 BatchSize = 50;
+	static Diamond graphs[BatchSize];
+	static DiamondTask tasks[BatchSize][4];
+
+	// lots of them in flight at once, so the tasks of different graphs get mixed up together
+	for (uint32 batch = 0; batch < NumGraphs; batch += BatchSize)
+	{
+		for (uint32 i = 0; i < BatchSize; i++)
+			submitDiamond(&graphs[i], tasks[i], false);
+
+		for (uint32 i = 0; i < BatchSize; i++)
+		{
+			Diamond* d = &graphs[i];
+			waitForJob(&d->Result);
+
+			bool ok = d->Result.Result == JobResult::Completed &&
+				d->Runs[0] == 1 && d->Runs[1] == 1 && d->Runs[2] == 1 && d->Runs[3] == 1 &&
+				d->Order[0] < d->Order[1] && d->Order[0] < d->Order[2] &&
+				d->Order[3] > d->Order[1] && d->Order[3] > d->Order[2];
+			if (check(ok, "diamond graphs run every task once, in order", workers) == false)
+				return;
+		}
+	}
+
+	// when the first task fails, nothing after it runs
+	submitDiamond(&graphs[0], tasks[0], true);
+	waitForJob(&graphs[0].Result);
+	check(graphs[0].Result.Result == JobResult::Error && graphs[0].Runs[0] == 1 &&
+		graphs[0].Runs[1] == 0 && graphs[0].Runs[2] == 0 && graphs[0].Runs[3] == 0,
+		"a failed task skips the tasks after it", workers);
+
+	// cycles are refused up front, without running anything
+	Diamond* d = &graphs[1];
+	TaskGraph g;
+	TaskID a = g.AddTask(diamondTask, &tasks[1][0]);
+	TaskID b = g.AddTask(diamondTask, &tasks[1][1]);
+	tasks[1][0] = { d, 0 };
+	tasks[1][1] = { d, 1 };
+	d->Runs[0] = d->Runs[1] = 0;
+	d->FailFirst = false;
+
+	check(g.AddDependency(a, a) == false, "a task can't depend on itself", workers);
+	g.AddDependency(a, b);
+	g.AddDependency(b, a);
+	check(g.Submit(&d->Result) == JobQueue::INVALID_JOB && d->Result.Result == JobResult::Error &&
+		d->Runs[0] == 0 && d->Runs[1] == 0, "graphs with cycles are refused", workers);
+}
+
+// Jobs that wait on their children from a worker. There are more of them than there are fibers,
+// so some of the waits park a fiber and the rest fall back to running other jobs in the meantime.
+static const uint32 NumWaitingJobs = 300;
+static std::atomic<bool> g_childDone[NumWaitingJobs];
+static std::atomic<bool> g_parentSawChild[NumWaitingJobs];
+
+static bool childJob(void* data)
+{
+	uint32 index = *(uint32*)data;
+
+	// give the parent a chance to actually wait
+	std::this_thread::sleep_for(std::chrono::microseconds(50));
+	g_childDone[index] = true;
+
+	return true;
+}
+
+static bool waitingParentJob(void* data)
+{
+	uint32 index = *(uint32*)data;
+
+	JobHandle child;
+	while ((child = JobQueue::AddJob(childJob, nullptr, nullptr, &index, sizeof(index))) == JobQueue::INVALID_JOB)
+		std::this_thread::yield();
+
+	JobQueue::WaitForJob(child);
+	g_parentSawChild[index] = g_childDone[index].load();
+
+	return true;
+}
+
+static void verifyWaits(uint32 workers)
+{
+	static JobInfo parents[NumWaitingJobs];
+	for (uint32 i = 0; i < NumWaitingJobs; i++)
+	{
+		g_childDone[i] = false;
+		g_parentSawChild[i] = false;
+		while (JobQueue::AddJob(waitingParentJob, nullptr, &parents[i], &i, sizeof(i)) == JobQueue::INVALID_JOB)
+			JobQueue::Tick();
+	}
+
+	bool ok = true;
+	for (uint32 i = 0; i < NumWaitingJobs; i++)
+	{
+		waitForJob(&parents[i]);
+		ok = ok && parents[i].Result == JobResult::Completed && g_parentSawChild[i];
+	}
+
+	check(ok, "jobs waiting on other jobs from a worker wake up once they're done", workers);
+}
+
+// Jobs that hold onto a worker until the gate opens
+static std::atomic<bool> g_gate;
+static std::atomic<uint32> g_gatedStarted;
+static std::atomic<uint32> g_gatedSawCancel;
+static std::atomic<uint32> g_targetRuns;
+
+static bool gatedJob(void* data)
+{
+	g_gatedStarted++;
+	while (g_gate == false)
+		std::this_thread::yield();
+
+	if (JobQueue::IsCancelled())
+		g_gatedSawCancel++;
+
+	return true;
+}
+
+static bool targetJob(void* data)
+{
+	g_targetRuns++;
+	return true;
+}
+
+static void waitForGatedJobs(uint32 count)
+{
+	while (g_gatedStarted < count)
+	{
+		JobQueue::Tick();
+		std::this_thread::yield();
+	}
+}
+
+static void verifyCancel(uint32 workers)
+{
+	static const uint32 MaxBlockers = JobQueueData::MaxThreads;
+	JobInfo blockers[MaxBlockers];
+
+	// tie up every worker, so the target can't start before it's cancelled
+	g_gate = false;
+	g_gatedStarted = 0;
+	g_gatedSawCancel = 0;
+	g_targetRuns = 0;
+	for (uint32 i = 0; i < workers; i++)
+		JobQueue::AddJob(gatedJob, nullptr, &blockers[i], nullptr, 0);
+	waitForGatedJobs(workers);
+
+	JobInfo target;
+	JobHandle targetHandle = JobQueue::AddJob(targetJob, nullptr, &target, nullptr, 0);
+	check(JobQueue::GetStatus(targetHandle) == JobStatus::Queued, "a job nobody's picked up is queued", workers);
+	check(JobQueue::Cancel(targetHandle), "a queued job can be cancelled", workers);
+
+	g_gate = true;
+	for (uint32 i = 0; i < workers; i++)
+		waitForJob(&blockers[i]);
+	waitForJob(&target);
+
+	check(target.Result == JobResult::Cancelled && g_targetRuns == 0, "a cancelled job never runs", workers);
+	check(JobQueue::GetStatus(targetHandle) == JobStatus::Done && JobQueue::Cancel(targetHandle) == false,
+		"a finished job is done and can't be cancelled", workers);
+
+	// Handles to finished jobs mustn't reach whatever job gets their slot next. Freed slots are reused
+	// first, so the next job almost always lands in the same one.
+	uint32 reused = 0;
+	for (uint32 i = 0; i < 100; i++)
+	{
+		JobInfo old;
+		JobHandle oldHandle = JobQueue::AddJob(targetJob, nullptr, &old, nullptr, 0);
+		waitForJob(&old);
+
+		g_gate = false;
+		g_gatedStarted = 0;
+		g_gatedSawCancel = 0;
+
+		JobInfo next;
+		JobHandle nextHandle = JobQueue::AddJob(gatedJob, nullptr, &next, nullptr, 0);
+		if (JOB_GET_INDEX(nextHandle) == JOB_GET_INDEX(oldHandle))
+			reused++;
+		waitForGatedJobs(1);
+
+		bool ok = JobQueue::GetStatus(oldHandle) == JobStatus::Done &&
+			JobQueue::Cancel(oldHandle) == false &&
+			JobQueue::GetStatus(nextHandle) == JobStatus::Running;
+
+		g_gate = true;
+		waitForJob(&next);
+
+		ok = ok && next.Result == JobResult::Completed && g_gatedSawCancel == 0;
+		if (check(ok, "old handles don't reach the job that reused their slot", workers) == false)
+			break;
+	}
+
+	check(reused > 0, "job slots get reused (otherwise the generation check wasn't tested)", workers);
+
+	// Cancel a job, then keep reusing its slot until the 16 bit checksum wraps back around to the
+	// cancelled one. None of the jobs along the way can start out cancelled.
+	g_gate = false;
+	g_gatedStarted = 0;
+	JobInfo cancelled;
+	JobHandle cancelledHandle = JobQueue::AddJob(gatedJob, nullptr, &cancelled, nullptr, 0);
+	waitForGatedJobs(1);
+	JobQueue::Cancel(cancelledHandle);
+	g_gate = true;
+	waitForJob(&cancelled);
+
+	static const uint32 NumWrapJobs = 0x10000;
+	uint32 sameSlot = 0;
+	g_targetRuns = 0;
+	for (uint32 i = 0; i < NumWrapJobs; i++)
+	{
+		JobInfo info;
+		JobHandle handle = JobQueue::AddJob(targetJob, nullptr, &info, nullptr, 0);
+		if (JOB_GET_INDEX(handle) == JOB_GET_INDEX(cancelledHandle))
+			sameSlot++;
+		waitForJob(&info);
+
+		if (check(info.Result == JobResult::Completed, "jobs in a slot that once had a cancelled job aren't cancelled", workers) == false)
+			break;
+	}
+
+	check(g_targetRuns == NumWrapJobs, "every job in a reused slot runs", workers);
+	check(sameSlot > 0x8000, "the slot gets reused past the checksum wrapping (otherwise it wasn't tested)", workers);
+}
+
+static void runVerify(const Options& options, uint32 numWorkers)
+{
+	JobQueueData* data = nullptr;
+	JobQueue::SetGlobalData(&data, numWorkers, options.PinThreads);
+
+	uint32 failures = g_failures;
+	verifyParallelFor(numWorkers);
+	verifyTaskGraphs(numWorkers);
+	verifyWaits(numWorkers);
+	verifyCancel(numWorkers);
+	printf("%u workers: %s\n", numWorkers, g_failures == failures ? "ok" : "FAILED");
+
+	JobQueue::Shutdown(true);
+}
+
+static bool parseOptions(int argc, char** argv, Options* result)
+{
+	uint32 numCores = std::thread::hardware_concurrency();
+
+	result->MaxWorkers = numCores > 1 ? numCores - 1 : 1;
+	result->NumJobs = 200000;
+	result->PinThreads = false;
+	result->Verify = false;
+	result->OutputFile = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			result->MaxWorkers = (uint32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			result->NumJobs = (uint32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-pin") == 0)
+			result->PinThreads = true;
+		else if (strcmp(argv[i], "-verify") == 0)
+			result->Verify = true;
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			result->OutputFile = argv[++i];
+		else
+			return false;
+	}
+
+	if (result->MaxWorkers == 0 || result->MaxWorkers > JobQueueData::MaxThreads || result->NumJobs == 0)
+		return false;
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (parseOptions(argc, argv, &options) == false)
+	{
+		printf("Usage:\n");
+		printf("\tjobbench [-t maxWorkers] [-n jobs] [-pin] [-o output.json]\n");
+		printf("\tjobbench -verify [-t maxWorkers] [-pin]\n");
+		return -1;
+	}
+
+	MemoryManager mem;
+	g_memory = &mem;
+	MemoryManagerInternal::SetDefaults(g_memory);
+	MemoryManagerInternal::Initialize();
+
+	LogData log;
+	memset(&log, 0, sizeof(LogData));
+	for (uint32 i = 0; i < LogData::NumLinePages; i++)
+		log.LineDataPages[i] = (char*)g_memory->AllocTrack(LogData::LineDataSize, __FILE__, __LINE__);
+	g_log = &log;
+
+	if (options.Verify)
+	{
+		// 1, 2, 4, ... workers, always finishing with the max
+		for (uint32 workers = 1; ; workers = workers * 2 < options.MaxWorkers ? workers * 2 : options.MaxWorkers)
+		{
+			runVerify(options, workers);
+			if (workers == options.MaxWorkers)
+				break;
+		}
+
+		for (uint32 i = 0; i < LogData::NumLinePages; i++)
+			g_memory->FreeTrack(log.LineDataPages[i], __FILE__, __LINE__);
+		MemoryManagerInternal::Shutdown();
+
+		return g_failures == 0 ? 0 : 1;
+	}
+
+	FILE* fp = stdout;
+	if (options.OutputFile)
+	{
+#ifdef _WIN32
+		if (fopen_s(&fp, options.OutputFile, "w") != 0)
+			fp = nullptr;
+#else
+		fp = fopen(options.OutputFile, "w");
+#endif
+		if (fp == nullptr)
+		{
+			printf("Unable to open %s\n", options.OutputFile);
+			return -1;
+		}
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"hardwareThreads\": %u,\n", std::thread::hardware_concurrency());
+	fprintf(fp, "\t\"jobs\": %u,\n", options.NumJobs);
+#ifdef GAME_ENABLE_JOB_FIBERS
+	fprintf(fp, "\t\"fibers\": true,\n");
+#else
+	fprintf(fp, "\t\"fibers\": false,\n");
+#endif
+#ifdef GAME_ENABLE_JOB_PROFILING
+	fprintf(fp, "\t\"profiling\": true,\n");
+#else
+	fprintf(fp, "\t\"profiling\": false,\n");
+#endif
+	fprintf(fp, "\t\"runs\": [\n");
+
+	// 1, 2, 4, ... workers, always finishing with the max
+	for (uint32 workers = 1; workers <= options.MaxWorkers; )
+	{
+		bool last = workers == options.MaxWorkers;
+		runBenchmarks(fp, options, workers, last);
+		fflush(fp);
+
+		if (last)
+			break;
+		workers = workers * 2 < options.MaxWorkers ? workers * 2 : options.MaxWorkers;
+	}
+
+	fprintf(fp, "\t]\n");
+	fprintf(fp, "}\n");
+
+	if (fp != stdout)
+		fclose(fp);
+
+	for (uint32 i = 0; i < LogData::NumLinePages; i++)
+		g_memory->FreeTrack(log.LineDataPages[i], __FILE__, __LINE__);
+	MemoryManagerInternal::Shutdown();
+
+	return 0;
+}
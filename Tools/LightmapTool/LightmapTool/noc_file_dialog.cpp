@@ -1,8 +1,8 @@
-#ifdef _WIN32
-#define NOC_FILE_DIALOG_WIN32
-#else
-// TODO
-#endif
-
-#define NOC_FILE_DIALOG_IMPLEMENTATION
+#ifdef _WIN32
+#define NOC_FILE_DIALOG_WIN32
+#else
+// TODO
+#endif
+
+#define NOC_FILE_DIALOG_IMPLEMENTATION
 #include "noc_file_dialog.h"
\ No newline at end of file
@@ -0,0 +1,291 @@
+// Headless pack file benchmark. Loads every file in each pack through FileFinder (so compressed packs
+// get decompressed by the job queue the same way the game does it) and writes the results as JSON, so
+// compressed packs can be compared against uncompressed ones. Each pack gets timed with a cold page
+// cache (it's evicted before every run, which only works on Linux) and a warm one.
+//
+// Usage: packbench [-t workers] [-n runs] [-o output.json] pack1.pak [pack2.pak ...]
+//
+// Build the packs from the same content, like "packer -o raw.pak ../../Content" and "packer -c -o compressed.pak ../../Content".
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../../Src/MemoryManager.cpp"
+#include "../../Src/Logging.cpp"
+#include "../../Src/Utils.cpp"
+#include "../../Src/FileSystem.cpp"
+#include "../../Src/HashStringManager.cpp"
+#include "../../Src/JobQueue.cpp"
+#include "../../Src/FileFinder.cpp"
+
+#define LZ4BLOCK_IMPLEMENTATION
+#include "../../Src/lz4block.h"
+
+MemoryManager* g_memory;
+
+// there's no console here, so there's nowhere to put the job queue's commands
+void Gui::Console::AddCommands(ConsoleCommand* commands, uint32 numCommands)
+{
+}
+
+struct Options
+{
+	static const uint32 MaxPacks = 8;
+	const char* Packs[MaxPacks];
+	uint32 NumPacks;
+	uint32 NumWorkers;
+	uint32 NumRuns;
+	const char* OutputFile;
+};
+
+struct BenchResult
+{
+	uint64 Bytes;
+	uint64 MinMicroseconds;
+	uint64 TotalMicroseconds;
+	uint32 Checksum;
+	bool Success;
+};
+
+// gets the pack out of the page cache, so the next run has to go all the way to the disk
+static bool evict(const char* path)
+{
+#if defined _WIN32 || defined __APPLE__
+	return false;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	fdatasync(fd);
+	bool success = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(fd);
+
+	return success;
+#endif
+}
+
+// gets the name of everything in the pack
+static void getNames(const char* path, std::vector<std::string>* result)
+{
+	// let FileFinder make sure it's valid first
+	FileFinderData* data = nullptr;
+	FileFinder::SetGlobalData(&data);
+	bool valid = FileFinder::AddArchive(path);
+	FileFinder::Shutdown();
+
+	File archive;
+	if (valid == false || FileSystem::OpenAndMap(path, &archive) == nullptr)
+		return;
+
+	auto header = (const PackHeader*)archive.Memory;
+	auto entries = (const PackEntry*)(header + 1);
+	const char* names = (const char*)((const PackBlock*)(entries + header->NumEntries) + header->NumBlocks);
+
+	for (uint32 i = 0; i < header->NumEntries; i++)
+		result->push_back(names + entries[i].NameOffset);
+
+	FileSystem::Close(&archive);
+}
+
+// opens the pack and reads every file in it, the way the content manager would
+static bool loadPack(const char* path, const std::vector<std::string>& names, uint64* bytes, uint32* checksum)
+{
+	FileFinderData* data = nullptr;
+	FileFinder::SetGlobalData(&data);
+
+	bool success = FileFinder::AddArchive(path);
+	if (success)
+	{
+		for (size_t i = 0; i < names.size() && success; i++)
+		{
+			FoundFile f;
+			success = FileFinder::OpenAndMap(names[i].c_str(), &f);
+			if (success)
+			{
+				// touch everything, since nothing's actually read from a mapped file until something looks at it
+				auto memory = (const uint8*)f.Memory;
+				uint32 sum = 0;
+				for (uint32 j = 0; j < f.FileSize; j++)
+					sum += memory[j];
+				*checksum += sum;
+				*bytes += f.FileSize;
+
+				FileFinder::Close(&f);
+			}
+		}
+	}
+
+	FileFinder::Shutdown();
+
+	return success;
+}
+
+static BenchResult benchPack(const char* path, const std::vector<std::string>& names, uint32 numRuns, bool cold)
+{
+	BenchResult result = {};
+	result.MinMicroseconds = (uint64)-1;
+	result.Success = true;
+
+	for (uint32 i = 0; i < numRuns && result.Success; i++)
+	{
+		if (cold && evict(path) == false)
+		{
+			result.Success = false;
+			break;
+		}
+
+		uint64 bytes = 0;
+		uint32 checksum = 0;
+
+		Utils::Stopwatch timer;
+		timer.Start();
+
+		result.Success = loadPack(path, names, &bytes, &checksum);
+
+		uint64 microseconds = timer.GetElapsedMicroseconds();
+		result.TotalMicroseconds += microseconds;
+		if (microseconds < result.MinMicroseconds)
+			result.MinMicroseconds = microseconds;
+		result.Bytes = bytes;
+		result.Checksum = checksum;
+	}
+
+	return result;
+}
+
+static void writeResult(FILE* fp, const char* name, const BenchResult& result, uint32 numRuns, bool comma)
+{
+	if (result.Success == false)
+	{
+		fprintf(fp, "\t\t\t\"%s\": null%s\n", name, comma ? "," : "");
+		return;
+	}
+
+	uint64 average = result.TotalMicroseconds / numRuns;
+	fprintf(fp, "\t\t\t\"%s\": { \"minMicroseconds\": %llu, \"averageMicroseconds\": %llu, \"megabytesPerSecond\": %.1f }%s\n",
+		name, (unsigned long long)result.MinMicroseconds, (unsigned long long)average,
+		result.MinMicroseconds > 0 ? result.Bytes / (double)result.MinMicroseconds : 0, comma ? "," : "");
+}
+
+static bool parseOptions(int argc, char** argv, Options* result)
+{
+	uint32 numCores = std::thread::hardware_concurrency();
+
+	result->NumPacks = 0;
+	result->NumWorkers = numCores > 1 ? numCores - 1 : 1;
+	result->NumRuns = 5;
+	result->OutputFile = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			result->NumWorkers = (uint32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			result->NumRuns = (uint32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			result->OutputFile = argv[++i];
+		else if (result->NumPacks < Options::MaxPacks)
+			result->Packs[result->NumPacks++] = argv[i];
+		else
+			return false;
+	}
+
+	if (result->NumPacks == 0 || result->NumWorkers == 0 || result->NumWorkers > JobQueueData::MaxThreads || result->NumRuns == 0)
+		return false;
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (parseOptions(argc, argv, &options) == false)
+	{
+		printf("Usage:\n");
+		printf("\tpackbench [-t workers] [-n runs] [-o output.json] pack1.pak [pack2.pak ...]\n");
+		return -1;
+	}
+
+	MemoryManager mem;
+	g_memory = &mem;
+	MemoryManagerInternal::SetDefaults(g_memory);
+	MemoryManagerInternal::Initialize();
+
+	LogData log;
+	memset(&log, 0, sizeof(LogData));
+	for (uint32 i = 0; i < LogData::NumLinePages; i++)
+		log.LineDataPages[i] = (char*)g_memory->AllocTrack(LogData::LineDataSize, __FILE__, __LINE__);
+	g_log = &log;
+
+	JobQueueData* jobQueue = nullptr;
+	JobQueue::SetGlobalData(&jobQueue, options.NumWorkers, false);
+
+	FILE* fp = stdout;
+	if (options.OutputFile)
+	{
+#ifdef _WIN32
+		if (fopen_s(&fp, options.OutputFile, "w") != 0)
+			fp = nullptr;
+#else
+		fp = fopen(options.OutputFile, "w");
+#endif
+		if (fp == nullptr)
+		{
+			printf("Unable to open %s\n", options.OutputFile);
+			return -1;
+		}
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"hardwareThreads\": %u,\n", std::thread::hardware_concurrency());
+	fprintf(fp, "\t\"workers\": %u,\n", options.NumWorkers);
+	fprintf(fp, "\t\"runs\": %u,\n", options.NumRuns);
+	fprintf(fp, "\t\"packs\": [\n");
+
+	for (uint32 i = 0; i < options.NumPacks; i++)
+	{
+		std::vector<std::string> names;
+		getNames(options.Packs[i], &names);
+		if (names.empty())
+		{
+			printf("Unable to read %s\n", options.Packs[i]);
+			return -1;
+		}
+
+		// warm goes second, so the cold runs leave it with everything cached
+		BenchResult cold = benchPack(options.Packs[i], names, options.NumRuns, true);
+		BenchResult warm = benchPack(options.Packs[i], names, options.NumRuns, false);
+
+		fprintf(fp, "\t\t{\n");
+		fprintf(fp, "\t\t\t\"pack\": \"%s\",\n", options.Packs[i]);
+		fprintf(fp, "\t\t\t\"bytes\": %llu,\n", (unsigned long long)warm.Bytes);
+		fprintf(fp, "\t\t\t\"checksum\": %u,\n", warm.Checksum);
+		writeResult(fp, "cold", cold, options.NumRuns, true);
+		writeResult(fp, "warm", warm, options.NumRuns, false);
+		fprintf(fp, "\t\t}%s\n", i + 1 < options.NumPacks ? "," : "");
+		fflush(fp);
+	}
+
+	fprintf(fp, "\t]\n");
+	fprintf(fp, "}\n");
+
+	if (fp != stdout)
+		fclose(fp);
+
+	JobQueue::Shutdown(true);
+	for (uint32 i = 0; i < LogData::NumLinePages; i++)
+		g_memory->FreeTrack(log.LineDataPages[i], __FILE__, __LINE__);
+	MemoryManagerInternal::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,299 @@
+// Builds a pack file (see Src/PackFile.h) out of everything in a content directory, so the game can
+// map the whole thing once at startup instead of opening every asset on its own.
+//
+// Usage: packer [-c] [-o content.pak] contentDirectory
+//
+// -c compresses everything that gets smaller (see lz4block.h)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+#include "../../Src/CleanWindows.h"
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "../../Src/Utils.h"
+#include "../../Src/PackFile.h"
+
+#define LZ4BLOCK_IMPLEMENTATION
+#include "../../Src/lz4block.h"
+
+struct Options
+{
+	const char* InputDirectory;
+	const char* OutputFile;
+	bool Compress;
+};
+
+struct InputFile
+{
+	std::string Name; // relative to the content directory, with forward slashes
+	uint32 Hash;
+};
+
+static bool parseOptions(int argc, char** argv, Options* result)
+{
+	result->InputDirectory = nullptr;
+	result->OutputFile = "content.pak";
+	result->Compress = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			result->OutputFile = argv[++i];
+		else if (strcmp(argv[i], "-c") == 0)
+			result->Compress = true;
+		else if (result->InputDirectory == nullptr)
+			result->InputDirectory = argv[i];
+		else
+			return false;
+	}
+
+	return result->InputDirectory != nullptr;
+}
+
+// adds every file under root/directory to files. Hidden files (like .gitignore) are skipped.
+static bool findFiles(const std::string& root, const std::string& directory, std::vector<InputFile>* files)
+{
+	std::string path = directory.empty() ? root : root + "/" + directory;
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((path + "/*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE)
+		return false;
+
+	do
+	{
+		if (data.cFileName[0] == '.')
+			continue;
+
+		std::string name = directory.empty() ? data.cFileName : directory + "/" + data.cFileName;
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			if (findFiles(root, name, files) == false)
+			{
+				FindClose(find);
+				return false;
+			}
+		}
+		else
+		{
+			files->push_back({ name, Utils::CalcHash(name.c_str()) });
+		}
+	} while (FindNextFileA(find, &data));
+
+	FindClose(find);
+#else
+	DIR* dir = opendir(path.c_str());
+	if (dir == nullptr)
+		return false;
+
+	dirent* entry;
+	while ((entry = readdir(dir)) != nullptr)
+	{
+		if (entry->d_name[0] == '.')
+			continue;
+
+		std::string name = directory.empty() ? entry->d_name : directory + "/" + entry->d_name;
+
+		struct stat sb;
+		if (stat((root + "/" + name).c_str(), &sb) == -1)
+			continue;
+
+		if (S_ISDIR(sb.st_mode))
+		{
+			if (findFiles(root, name, files) == false)
+			{
+				closedir(dir);
+				return false;
+			}
+		}
+		else if (S_ISREG(sb.st_mode))
+		{
+			files->push_back({ name, Utils::CalcHash(name.c_str()) });
+		}
+	}
+
+	closedir(dir);
+#endif
+
+	return true;
+}
+
+static bool readFile(const std::string& path, std::vector<uint8>* result)
+{
+	FILE* fp = fopen(path.c_str(), "rb");
+	if (fp == nullptr)
+		return false;
+
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	result->resize((size_t)size);
+	bool success = size == 0 || fread(result->data(), 1, (size_t)size, fp) == (size_t)size;
+	fclose(fp);
+
+	return success;
+}
+
+// compresses data one block at a time. Returns false if that doesn't make it any smaller.
+static bool compress(const std::vector<uint8>& data, uint32 blockSize, std::vector<uint8>* result, std::vector<PackBlock>* blocks)
+{
+	std::vector<uint8> buffer((size_t)lz4block_compress_bound((int)blockSize));
+
+	result->clear();
+	for (size_t offset = 0; offset < data.size(); offset += blockSize)
+	{
+		int size = (int)(data.size() - offset < blockSize ? data.size() - offset : blockSize);
+
+		// if it doesn't get smaller it's stored as is, and the game can tell since the sizes match
+		int compressedSize = lz4block_compress(data.data() + offset, size, buffer.data(), size - 1);
+		const uint8* block = compressedSize > 0 ? buffer.data() : data.data() + offset;
+		if (compressedSize == 0)
+			compressedSize = size;
+
+		blocks->push_back({ (uint32)result->size(), (uint32)compressedSize });
+		result->insert(result->end(), block, block + compressedSize);
+	}
+
+	return result->size() < data.size();
+}
+
+static uint32 getPadding(uint64 offset)
+{
+	return (uint32)((PackHeader::Alignment - offset % PackHeader::Alignment) % PackHeader::Alignment);
+}
+
+static bool writePadding(FILE* fp, uint64* offset)
+{
+	static const uint8 zeros[PackHeader::Alignment] = {};
+
+	uint32 padding = getPadding(*offset);
+	*offset += padding;
+
+	return padding == 0 || fwrite(zeros, 1, padding, fp) == padding;
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (parseOptions(argc, argv, &options) == false)
+	{
+		printf("Usage:\n");
+		printf("\tpacker [-c] [-o content.pak] contentDirectory\n");
+		return -1;
+	}
+
+	std::vector<InputFile> files;
+	if (findFiles(options.InputDirectory, "", &files) == false)
+	{
+		printf("Unable to read %s\n", options.InputDirectory);
+		return -1;
+	}
+
+	// the game does a binary search on the hashes, and sorting by name too keeps the output the same every time
+	std::sort(files.begin(), files.end(), [](const InputFile& a, const InputFile& b) {
+		return a.Hash != b.Hash ? a.Hash < b.Hash : a.Name < b.Name;
+	});
+
+	for (size_t i = 1; i < files.size(); i++)
+	{
+		if (files[i].Hash == files[i - 1].Hash)
+			printf("Warning: %s and %s have the same hash (that's fine, lookups just get a little slower)\n", files[i - 1].Name.c_str(), files[i].Name.c_str());
+	}
+
+	PackHeader header = {};
+	header.FourCC = PackHeader::Magic;
+	header.Version = PackHeader::CurrentVersion;
+	header.NumEntries = (uint32)files.size();
+	header.BlockSize = PackHeader::DefaultBlockSize;
+
+	std::vector<PackEntry> entries(files.size());
+	std::string names;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		entries[i].NameHash = files[i].Hash;
+		entries[i].NameOffset = (uint32)names.size();
+		names += files[i].Name;
+		names += '\0';
+	}
+	header.NamesSize = (uint32)names.size();
+
+	// read (and compress) everything first, since the whole table of contents comes before the data
+	std::vector<std::vector<uint8>> data(files.size());
+	std::vector<PackBlock> blocks;
+	uint64 totalSize = 0;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (readFile(std::string(options.InputDirectory) + "/" + files[i].Name, &data[i]) == false)
+		{
+			printf("Unable to read %s\n", files[i].Name.c_str());
+			return -1;
+		}
+
+		entries[i].Size = data[i].size();
+		totalSize += data[i].size();
+
+		std::vector<uint8> compressed;
+		std::vector<PackBlock> fileBlocks;
+		if (options.Compress && compress(data[i], header.BlockSize, &compressed, &fileBlocks))
+		{
+			entries[i].FirstBlock = (uint32)blocks.size();
+			entries[i].NumBlocks = (uint32)fileBlocks.size();
+			blocks.insert(blocks.end(), fileBlocks.begin(), fileBlocks.end());
+			data[i].swap(compressed);
+		}
+
+		entries[i].StoredSize = data[i].size();
+	}
+	header.NumBlocks = (uint32)blocks.size();
+
+	uint64 offset = sizeof(PackHeader) + sizeof(PackEntry) * entries.size() + sizeof(PackBlock) * blocks.size() + names.size();
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		offset += getPadding(offset);
+		entries[i].Offset = offset;
+		offset += data[i].size();
+	}
+
+	FILE* fp = fopen(options.OutputFile, "wb");
+	if (fp == nullptr)
+	{
+		printf("Unable to open %s\n", options.OutputFile);
+		return -1;
+	}
+
+	bool success = fwrite(&header, sizeof(PackHeader), 1, fp) == 1 &&
+		(entries.empty() || fwrite(entries.data(), sizeof(PackEntry), entries.size(), fp) == entries.size()) &&
+		(blocks.empty() || fwrite(blocks.data(), sizeof(PackBlock), blocks.size(), fp) == blocks.size()) &&
+		fwrite(names.data(), 1, names.size(), fp) == names.size();
+
+	offset = sizeof(PackHeader) + sizeof(PackEntry) * entries.size() + sizeof(PackBlock) * blocks.size() + names.size();
+	for (size_t i = 0; i < files.size() && success; i++)
+	{
+		success = writePadding(fp, &offset) &&
+			(data[i].empty() || fwrite(data[i].data(), 1, data[i].size(), fp) == data[i].size());
+		offset += data[i].size();
+	}
+
+	fclose(fp);
+
+	if (success == false)
+	{
+		printf("Unable to write %s\n", options.OutputFile);
+		return -1;
+	}
+
+	printf("Packed %u files (%llu bytes) into %s (%llu bytes)\n", header.NumEntries, (unsigned long long)totalSize, options.OutputFile, (unsigned long long)offset);
+
+	return 0;
+}